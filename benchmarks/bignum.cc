@@ -0,0 +1,199 @@
+// Measure each operation of `BigNum`, on operands from one up to ten million
+// decimal digits. Use `--benchmark_out_format=json` to track regressions.
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "bignum/bignum.hh"
+
+using namespace abacus::bignum;
+
+namespace {
+
+auto constexpr MAX_DIGITS = std::int64_t(10'000'000);
+
+std::string random_decimal(std::size_t digits, std::uint64_t seed) {
+    auto rng = std::mt19937_64(seed);
+    auto distribution = std::uniform_int_distribution<int>(0, 9);
+
+    std::string res(digits, '0');
+    for (auto& c : res) {
+        c = '0' + distribution(rng);
+    }
+    // Keep the requested size
+    if (res.front() == '0') {
+        res.front() = '1';
+    }
+    return res;
+}
+
+// Random operands are memoized, as the largest ones are slow to build
+BigNum const& random_num(std::size_t digits, std::uint64_t seed = 0) {
+    static std::map<std::pair<std::size_t, std::uint64_t>, BigNum> nums;
+
+    auto [it, inserted] = nums.try_emplace({digits, seed});
+    if (inserted) {
+        it->second = BigNum(std::string_view(random_decimal(digits, seed)));
+    }
+    return it->second;
+}
+
+// Operand sizes, in decimal digits, by powers of ten
+void sizes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->RangeMultiplier(10)
+        ->Range(1, MAX_DIGITS)
+        ->Unit(benchmark::kMicrosecond);
+}
+
+void BM_add(benchmark::State& state) {
+    auto const& lhs = random_num(state.range(0), 0);
+    auto const& rhs = random_num(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs + rhs);
+    }
+}
+BENCHMARK(BM_add)->Apply(sizes);
+
+void BM_substract(benchmark::State& state) {
+    auto const& lhs = random_num(state.range(0), 0);
+    auto const& rhs = random_num(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs - rhs);
+    }
+}
+BENCHMARK(BM_substract)->Apply(sizes);
+
+void BM_multiply(benchmark::State& state) {
+    auto const& lhs = random_num(state.range(0), 0);
+    auto const& rhs = random_num(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs * rhs);
+    }
+}
+BENCHMARK(BM_multiply)->Apply(sizes);
+
+// Aliased operands take the dedicated squaring path
+void BM_square(benchmark::State& state) {
+    auto const& num = random_num(state.range(0), 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(num * num);
+    }
+}
+BENCHMARK(BM_square)->Apply(sizes);
+
+// The quotient is as long as the divisor
+void BM_divide(benchmark::State& state) {
+    auto const& lhs = random_num(2 * state.range(0), 0);
+    auto const& rhs = random_num(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs / rhs);
+    }
+}
+BENCHMARK(BM_divide)->Apply(sizes);
+
+void BM_modulo(benchmark::State& state) {
+    auto const& lhs = random_num(2 * state.range(0), 0);
+    auto const& rhs = random_num(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs % rhs);
+    }
+}
+BENCHMARK(BM_modulo)->Apply(sizes);
+
+// Raise a small base to a result of the given size
+void BM_pow(benchmark::State& state) {
+    auto const base = BigNum(3);
+    auto const exponent
+        = BigNum(std::int64_t(state.range(0) / std::log10(3.0)) + 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pow(base, exponent));
+    }
+}
+BENCHMARK(BM_pow)->Apply(sizes);
+
+// Powers of two are a shift, powers of ten one of five
+void BM_pow_two(benchmark::State& state) {
+    auto const base = BigNum(2);
+    auto const exponent
+        = BigNum(std::int64_t(state.range(0) / std::log10(2.0)) + 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pow(base, exponent));
+    }
+}
+BENCHMARK(BM_pow_two)->Apply(sizes);
+
+void BM_pow_ten(benchmark::State& state) {
+    auto const base = BigNum(10);
+    auto const exponent = BigNum(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pow(base, exponent));
+    }
+}
+BENCHMARK(BM_pow_ten)->Apply(sizes);
+
+// Exponent and modulus of the given size, the latter even or odd to measure
+// both reductions
+void BM_pow_mod(benchmark::State& state) {
+    auto const& base = random_num(state.range(0), 0);
+    auto const& exponent = random_num(state.range(0), 1);
+    auto const modulus
+        = random_num(state.range(0), 2) * BigNum(2) + BigNum(state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pow_mod(base, exponent, modulus));
+    }
+}
+BENCHMARK(BM_pow_mod)->ArgsProduct({{10, 100, 1000}, {0, 1}});
+
+void BM_sqrt(benchmark::State& state) {
+    auto const& num = random_num(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sqrt(num));
+    }
+}
+BENCHMARK(BM_sqrt)->Apply(sizes);
+
+void BM_log2(benchmark::State& state) {
+    auto const& num = random_num(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(log2(num));
+    }
+}
+BENCHMARK(BM_log2)->Apply(sizes);
+
+void BM_log10(benchmark::State& state) {
+    auto const& num = random_num(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(log10(num));
+    }
+}
+BENCHMARK(BM_log10)->Apply(sizes);
+
+void BM_read(benchmark::State& state) {
+    auto const decimal = random_decimal(state.range(0), 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BigNum(std::string_view(decimal)));
+    }
+    state.SetBytesProcessed(state.iterations() * decimal.size());
+}
+BENCHMARK(BM_read)->Apply(sizes);
+
+void BM_dump(benchmark::State& state) {
+    auto const& num = random_num(state.range(0));
+    for (auto _ : state) {
+        std::ostringstream out;
+        out << num;
+        benchmark::DoNotOptimize(out.str());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_dump)->Apply(sizes);
+
+} // namespace
+
+BENCHMARK_MAIN();
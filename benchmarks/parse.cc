@@ -0,0 +1,94 @@
+// Measure the whole pipeline of `ParserDriver`, from scanning the input to
+// evaluating it. Use `--benchmark_out_format=json` to track regressions.
+
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "parse/parser-driver.hh"
+
+using abacus::parse::ParserDriver;
+
+namespace {
+
+std::string random_decimal(std::size_t digits) {
+    auto rng = std::mt19937_64(0);
+    auto distribution = std::uniform_int_distribution<int>(0, 9);
+
+    std::string res(digits, '0');
+    for (auto& c : res) {
+        c = '0' + distribution(rng);
+    }
+    return res;
+}
+
+// A single literal, from one up to ten million digits
+void BM_parse_literal(benchmark::State& state) {
+    auto const input = random_decimal(state.range(0));
+    ParserDriver driver;
+    for (auto _ : state) {
+        driver.parse_string(input);
+        benchmark::DoNotOptimize(driver.result());
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_parse_literal)
+    ->RangeMultiplier(10)
+    ->Range(1, 10'000'000)
+    ->Unit(benchmark::kMicrosecond);
+
+// A long expression of small terms, mostly measuring the parser and the AST
+void BM_parse_expression(benchmark::State& state) {
+    std::string input = "1";
+    for (std::int64_t i = 1; i < state.range(0); ++i) {
+        input += (i % 2 == 0 ? " + " : " - ") + std::to_string(i) + " * ("
+               + std::to_string(i + 1) + " - " + std::to_string(i + 2) + ")";
+    }
+
+    ParserDriver driver;
+    for (auto _ : state) {
+        driver.parse_string(input);
+        benchmark::DoNotOptimize(driver.result());
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_parse_expression)
+    ->RangeMultiplier(10)
+    ->Range(1, 1'000'000)
+    ->Unit(benchmark::kMicrosecond);
+
+// Streaming a file of small expressions, one per line
+void BM_stream(benchmark::State& state) {
+    auto const path = std::filesystem::temp_directory_path()
+                    / "abacus-benchmark-stream.txt";
+    {
+        std::ofstream file(path);
+        for (std::int64_t i = 0; i < state.range(0); ++i) {
+            file << i << " * (" << i + 1 << " + 12345678901234567890)\n";
+        }
+    }
+
+    ParserDriver driver;
+    std::ostream discard(nullptr);
+    for (auto _ : state) {
+        driver.stream(path, discard);
+    }
+    state.SetBytesProcessed(state.iterations()
+                            * std::filesystem::file_size(path));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_stream)
+    ->RangeMultiplier(10)
+    ->Range(1, 1'000'000)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,200 @@
+// Measure the operand sizes from which each multiplication, division, or
+// decimal conversion algorithm beats the previous one, to be used as the
+// defaults in `bignum/tuning.hh`.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "bignum/bignum.hh"
+#include "bignum/modular.hh"
+#include "bignum/tuning.hh"
+
+using namespace abacus::bignum;
+
+namespace {
+
+// Decimal digits per limb, rounded down
+auto constexpr DIGITS_PER_LIMB = 19;
+
+// Measure each configuration a few times, for at least this long
+auto constexpr BATCHES = 3;
+auto constexpr BATCH_DURATION = std::chrono::milliseconds(20);
+
+// Consecutive wins needed to declare a crossover
+auto constexpr WINS = 3;
+
+BigNum random_num(std::size_t limbs, std::mt19937_64& rng) {
+    auto distribution = std::uniform_int_distribution<int>(0, 9);
+
+    std::string str(limbs * DIGITS_PER_LIMB, '0');
+    for (auto& c : str) {
+        c = '0' + distribution(rng);
+    }
+    str.front() = '9';
+
+    BigNum res;
+    std::stringstream(str) >> res;
+    return res;
+}
+
+// Duration of a single operation, in seconds, keeping the best of a few
+// batches to filter out noise
+template <typename Operation>
+double time_operation(Operation operation, BigNum const& lhs,
+                      BigNum const& rhs) {
+    using clock = std::chrono::steady_clock;
+
+    auto best = std::numeric_limits<double>::infinity();
+    for (int batch = 0; batch < BATCHES; ++batch) {
+        auto const start = clock::now();
+        auto iterations = 0;
+        auto end = start;
+        do {
+            auto volatile res = operation(lhs, rhs).is_zero();
+            (void)res;
+            ++iterations;
+            end = clock::now();
+        } while (end - start < BATCH_DURATION);
+
+        auto const duration = std::chrono::duration<double>(end - start);
+        best = std::min(best, duration.count() / iterations);
+    }
+
+    return best;
+}
+
+// Operand sizes, in limbs, used to measure a given threshold size
+using Shape = std::pair<std::size_t, std::size_t> (*)(std::size_t);
+
+// Find the smallest size from which enabling an algorithm, on top of the ones
+// already tuned, is consistently faster
+template <typename Operation>
+std::size_t find_crossover(std::size_t Thresholds::*threshold,
+                           std::size_t start, Shape shape, Operation operation,
+                           std::mt19937_64& rng) {
+    auto const disabled = std::numeric_limits<std::size_t>::max();
+
+    auto wins = 0;
+    auto candidate = disabled;
+    for (auto size = start; size < 16384; size += size / 8 + 1) {
+        auto const [lhs_size, rhs_size] = shape(size);
+        auto const lhs = random_num(lhs_size, rng);
+        auto const rhs = random_num(rhs_size, rng);
+
+        thresholds().*threshold = disabled;
+        auto const before = time_operation(operation, lhs, rhs);
+        thresholds().*threshold = size;
+        auto const after = time_operation(operation, lhs, rhs);
+
+        std::cerr << size << ": " << before << "s vs " << after << "s\n";
+
+        if (after < before) {
+            if (wins++ == 0) {
+                candidate = size;
+            }
+            if (wins == WINS) {
+                thresholds().*threshold = candidate;
+                return candidate;
+            }
+        } else {
+            wins = 0;
+        }
+    }
+
+    thresholds().*threshold = disabled;
+    return disabled;
+}
+
+} // namespace
+
+int main() {
+    auto rng = std::mt19937_64(42);
+
+    auto const multiplication = [](auto const& lhs, auto const& rhs) {
+        return lhs * rhs;
+    };
+    // Ignores `rhs`, squaring `lhs` through aliased operands
+    auto const squaring = [](auto const& lhs, auto const&) {
+        return lhs * lhs;
+    };
+    auto const division = [](auto const& lhs, auto const& rhs) {
+        return lhs / rhs;
+    };
+    auto const printing = [](auto const& lhs, auto const&) {
+        std::ostringstream out;
+        out << lhs;
+        return BigNum(out.str().size());
+    };
+    // A fresh context picks up the threshold, the exponent being long enough
+    // for its set-up to be negligible, and the modulus odd to use Montgomery's
+    // reduction
+    auto const exponent = pow(BigNum(2), BigNum(64)) - BigNum(1);
+    auto const modular_power = [&](auto const& lhs, auto const& rhs) {
+        return Modulus(rhs * BigNum(2) + BigNum(1)).pow(lhs, exponent);
+    };
+
+    auto const balanced = [](std::size_t size) {
+        return std::make_pair(size, size);
+    };
+    // The quotient is `size` limbs long, and half as long as the divisor
+    auto const short_quotient = [](std::size_t size) {
+        return std::make_pair(3 * size, 2 * size);
+    };
+    auto const unary = [](std::size_t size) {
+        return std::make_pair(size, std::size_t(1));
+    };
+
+    thresholds().toom3 = std::numeric_limits<std::size_t>::max();
+    thresholds().ntt = std::numeric_limits<std::size_t>::max();
+    thresholds().toom3_square = std::numeric_limits<std::size_t>::max();
+    thresholds().ntt_square = std::numeric_limits<std::size_t>::max();
+    thresholds().recursive_division = std::numeric_limits<std::size_t>::max();
+    thresholds().radix_conversion = std::numeric_limits<std::size_t>::max();
+    thresholds().montgomery_products = std::numeric_limits<std::size_t>::max();
+
+    std::cerr << "Tuning Karatsuba...\n";
+    auto const karatsuba = find_crossover(&Thresholds::karatsuba, 4, balanced,
+                                          multiplication, rng);
+    std::cerr << "Tuning Toom-3...\n";
+    auto const toom3 = find_crossover(&Thresholds::toom3, karatsuba, balanced,
+                                      multiplication, rng);
+    std::cerr << "Tuning NTT...\n";
+    auto const ntt = find_crossover(&Thresholds::ntt, toom3, balanced,
+                                    multiplication, rng);
+    std::cerr << "Tuning Karatsuba squaring...\n";
+    auto const karatsuba_square = find_crossover(
+        &Thresholds::karatsuba_square, 4, unary, squaring, rng);
+    std::cerr << "Tuning Toom-3 squaring...\n";
+    auto const toom3_square = find_crossover(
+        &Thresholds::toom3_square, karatsuba_square, unary, squaring, rng);
+    std::cerr << "Tuning NTT squaring...\n";
+    auto const ntt_square = find_crossover(&Thresholds::ntt_square,
+                                           toom3_square, unary, squaring, rng);
+    std::cerr << "Tuning recursive division...\n";
+    auto const recursive_division
+        = find_crossover(&Thresholds::recursive_division, 4, short_quotient,
+                         division, rng);
+    std::cerr << "Tuning radix conversion...\n";
+    auto const radix_conversion = find_crossover(
+        &Thresholds::radix_conversion, 4, unary, printing, rng);
+    std::cerr << "Tuning Montgomery reduction...\n";
+    auto const montgomery_products
+        = find_crossover(&Thresholds::montgomery_products, karatsuba,
+                         balanced, modular_power, rng);
+
+    std::cout << "karatsuba = " << karatsuba << '\n';
+    std::cout << "toom3 = " << toom3 << '\n';
+    std::cout << "ntt = " << ntt << '\n';
+    std::cout << "karatsuba_square = " << karatsuba_square << '\n';
+    std::cout << "toom3_square = " << toom3_square << '\n';
+    std::cout << "ntt_square = " << ntt_square << '\n';
+    std::cout << "recursive_division = " << recursive_division << '\n';
+    std::cout << "radix_conversion = " << radix_conversion << '\n';
+    std::cout << "montgomery_products = " << montgomery_products << '\n';
+}
@@ -46,6 +46,7 @@
           ];
 
           checkInputs = with final; [
+            gbenchmark
             gtest
           ];
 
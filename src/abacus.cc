@@ -1,9 +1,94 @@
 #include "parse/parser-driver.hh"
 
-int main() {
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <cstdlib>
+
+#include "bignum/stats.hh"
+#include "bignum/tuning.hh"
+#include "parallel/thread-pool.hh"
+#include "server/server.hh"
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+double milliseconds(clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    abacus::bignum::threads() = abacus::parallel::ThreadPool::default_threads();
+
+    auto const usage = [&] {
+        std::cerr << "usage: " << argv[0] << " [--stream] [--stats] [FILE]\n"
+                  << "       " << argv[0] << " --serve SOCKET\n";
+        return EXIT_FAILURE;
+    };
+
+    // Keep answering requests sent on a socket, see `abacus-client`
+    if (argc >= 2 && std::string_view(argv[1]) == "--serve") {
+        if (argc != 3) {
+            return usage();
+        }
+        try {
+            abacus::server::serve(argv[2]);
+        } catch (std::exception const& e) {
+            std::cerr << "cannot serve on " << argv[2] << ": " << e.what()
+                      << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Evaluate each line of the input in turn, instead of a single expression
+    bool stream = false;
+    // Report where the time went on the standard error
+    bool stats = false;
+    std::optional<std::string> filename;
+
+    for (int i = 1; i < argc; ++i) {
+        auto const arg = std::string_view(argv[i]);
+        if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (!filename && (arg == "-" || !arg.starts_with("--"))) {
+            filename = arg;
+        } else {
+            return usage();
+        }
+    }
+
     abacus::parse::ParserDriver driver{};
 
-    driver.parse("-");
+    auto const start = clock::now();
+    int res = EXIT_SUCCESS;
+    if (stream) {
+        res = driver.stream(filename.value_or("-"), std::cout);
+    } else if (driver.parse(filename.value_or("-")) != 0) {
+        res = EXIT_FAILURE;
+    }
+    auto const evaluated = clock::now();
+    if (!stream && res == EXIT_SUCCESS) {
+        std::cout << driver.result() << std::flush;
+    }
+    auto const end = clock::now();
+
+    if (stats) {
+        std::cerr << "total: " << milliseconds(end - start) << "ms, "
+                  << (stream ? "streaming: " : "parsing and evaluating: ")
+                  << milliseconds(evaluated - start) << "ms, printing: "
+                  << milliseconds(end - evaluated) << "ms\n";
+        abacus::bignum::stats::report(std::cerr,
+                                      abacus::bignum::stats::snapshot());
+    }
 
-    std::cout << driver.result();
+    return res;
 }
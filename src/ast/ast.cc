@@ -0,0 +1,114 @@
+#include "ast.hh"
+
+#include <algorithm>
+#include <utility>
+
+#include <cassert>
+
+namespace abacus::ast {
+
+int arity(Operation op) {
+    switch (op) {
+    case Operation::Literal:
+    case Operation::Variable:
+        return 0;
+    case Operation::Negate:
+    case Operation::Square:
+        return 1;
+    case Operation::Add:
+    case Operation::Substract:
+    case Operation::Multiply:
+    case Operation::Divide:
+        return 2;
+    case Operation::PowMod:
+        return 3;
+    }
+
+    assert(false);
+    return 0;
+}
+
+NodeId Ast::literal(bignum::BigNum value) {
+    literals_.push_back(std::move(value));
+    return push({Operation::Literal, NodeId(literals_.size() - 1)});
+}
+
+NodeId Ast::variable(std::string name) {
+    return push({Operation::Variable, declare(std::move(name))});
+}
+
+NodeId Ast::declare(std::string name) {
+    auto const it = std::find(variables_.begin(), variables_.end(), name);
+    if (it != variables_.end()) {
+        return it - variables_.begin();
+    }
+
+    variables_.push_back(std::move(name));
+    return variables_.size() - 1;
+}
+
+NodeId Ast::unary(Operation op, NodeId operand) {
+    assert(arity(op) == 1);
+    assert(operand < nodes_.size());
+
+    return push({op, operand});
+}
+
+NodeId Ast::binary(Operation op, NodeId lhs, NodeId rhs) {
+    assert(arity(op) == 2);
+    assert(lhs < nodes_.size());
+    assert(rhs < nodes_.size());
+
+    return push({op, lhs, rhs});
+}
+
+NodeId Ast::ternary(Operation op, NodeId lhs, NodeId rhs, NodeId extra) {
+    assert(arity(op) == 3);
+    assert(lhs < nodes_.size());
+    assert(rhs < nodes_.size());
+    assert(extra < nodes_.size());
+
+    return push({op, lhs, rhs, extra});
+}
+
+Node const& Ast::node(NodeId id) const {
+    assert(id < nodes_.size());
+    return nodes_[id];
+}
+
+bignum::BigNum const& Ast::value(Node const& node) const {
+    assert(node.op == Operation::Literal);
+    assert(node.lhs < literals_.size());
+    return literals_[node.lhs];
+}
+
+std::string const& Ast::name(Node const& node) const {
+    assert(node.op == Operation::Variable);
+    assert(node.lhs < variables_.size());
+    return variables_[node.lhs];
+}
+
+std::span<std::string const> Ast::variables() const {
+    return variables_;
+}
+
+std::span<Node const> Ast::nodes() const {
+    return nodes_;
+}
+
+bool Ast::empty() const {
+    return nodes_.empty();
+}
+
+void Ast::clear() {
+    nodes_.clear();
+    literals_.clear();
+    variables_.clear();
+}
+
+NodeId Ast::push(Node node) {
+    nodes_.push_back(node);
+    return nodes_.size() - 1;
+}
+
+} // namespace abacus::ast
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "bignum/bignum.hh"
+
+namespace abacus::ast {
+
+using NodeId = std::uint32_t;
+
+enum class Operation : std::uint8_t {
+    Literal,
+    Variable,
+    Negate,
+    Square,
+    Add,
+    Substract,
+    Multiply,
+    Divide,
+    PowMod,
+};
+
+// Number of operands of an operation
+int arity(Operation op);
+
+struct Node {
+    Operation op;
+    // Index of the value for `Literal`, of the name for `Variable`, of the
+    // operands otherwise
+    NodeId lhs = 0;
+    NodeId rhs = 0;
+    // Third operand of ternary operations, e.g: the modulus of `PowMod`
+    NodeId extra = 0;
+
+    friend bool operator==(Node const& lhs, Node const& rhs) = default;
+};
+
+// Expression trees stored in a flat arena, nodes referring to each other by
+// index. They are created bottom-up, so that operands always come before the
+// nodes using them.
+class Ast {
+public:
+    NodeId literal(bignum::BigNum value);
+    // Uses of the same name refer to the same variable
+    NodeId variable(std::string name);
+    // Register a variable without using it, returning its index
+    NodeId declare(std::string name);
+    NodeId unary(Operation op, NodeId operand);
+    NodeId binary(Operation op, NodeId lhs, NodeId rhs);
+    NodeId ternary(Operation op, NodeId lhs, NodeId rhs, NodeId extra);
+
+    Node const& node(NodeId id) const;
+    bignum::BigNum const& value(Node const& node) const;
+    std::string const& name(Node const& node) const;
+
+    // Names of the variables, in order of appearance
+    std::span<std::string const> variables() const;
+
+    std::span<Node const> nodes() const;
+    bool empty() const;
+
+    void clear();
+
+private:
+    NodeId push(Node node);
+
+    std::vector<Node> nodes_{};
+    // Kept on the side to keep nodes small
+    std::vector<bignum::BigNum> literals_{};
+    std::vector<std::string> variables_{};
+};
+
+} // namespace abacus::ast
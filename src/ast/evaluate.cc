@@ -0,0 +1,356 @@
+#include "evaluate.hh"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+
+namespace abacus::ast {
+
+using bignum::BigNum;
+
+namespace {
+
+// Below this estimated number of limb operations, a node is computed by the
+// thread which made it ready rather than queued, as it would not be worth it
+constexpr std::size_t PARALLEL_GRAIN = std::size_t(1) << 14;
+
+// Keeps estimates for ever-growing values, e.g: repeated squares, in range
+constexpr std::size_t MAX_LIMBS = std::size_t(1) << 31;
+
+// Product of limb counts, saturated rather than wrapping around
+std::size_t saturating_multiply(std::size_t lhs, std::size_t rhs) {
+    auto constexpr max = std::numeric_limits<std::size_t>::max();
+    return rhs != 0 && lhs > max / rhs ? max : lhs * rhs;
+}
+
+template <typename Lhs, typename Rhs>
+BigNum apply(Operation op, Lhs&& lhs, Rhs&& rhs) {
+    switch (op) {
+    case Operation::Add:
+        return std::forward<Lhs>(lhs) + std::forward<Rhs>(rhs);
+    case Operation::Substract:
+        return std::forward<Lhs>(lhs) - std::forward<Rhs>(rhs);
+    case Operation::Multiply:
+        return std::forward<Lhs>(lhs) * std::forward<Rhs>(rhs);
+    case Operation::Divide:
+        return std::forward<Lhs>(lhs) / std::forward<Rhs>(rhs);
+    case Operation::Literal:
+    case Operation::Variable:
+    case Operation::Negate:
+    case Operation::Square:
+    case Operation::PowMod:
+        break;
+    }
+
+    assert(false);
+    return BigNum();
+}
+
+// Compute an operation, `with_operand(id, function)` handing the value of
+// operand `id` over to `function`
+template <typename WithOperand>
+BigNum compute(Node const& node, WithOperand const& with_operand) {
+    if (node.op == Operation::Negate) {
+        return with_operand(node.lhs, [](auto&& operand) {
+            return -std::forward<decltype(operand)>(operand);
+        });
+    }
+
+    if (node.op == Operation::Square) {
+        return with_operand(node.lhs, [](auto&& operand) {
+            return operand * operand;
+        });
+    }
+
+    if (node.op == Operation::PowMod) {
+        return with_operand(node.lhs, [&](auto&& base) {
+            return with_operand(node.rhs, [&](auto&& exponent) {
+                return with_operand(node.extra, [&](auto&& modulus) {
+                    return pow_mod(base, exponent, modulus);
+                });
+            });
+        });
+    }
+
+    return with_operand(node.lhs, [&](auto&& lhs) {
+        return with_operand(node.rhs, [&](auto&& rhs) {
+            return apply(node.op, std::forward<decltype(lhs)>(lhs),
+                         std::forward<decltype(rhs)>(rhs));
+        });
+    });
+}
+
+BigNum const& leaf(Ast const& ast, Node const& node,
+                   std::span<BigNum const> variables) {
+    if (node.op == Operation::Literal) {
+        return ast.value(node);
+    }
+    if (node.lhs >= variables.size()) {
+        throw std::invalid_argument("unbound variable: " + ast.name(node));
+    }
+    return variables[node.lhs];
+}
+
+// Count the uses of each node needed by the root, going top-down
+std::vector<std::size_t> count_uses(std::span<Node const> nodes, NodeId root) {
+    std::vector<std::size_t> uses(root + 1, 0);
+    uses[root] = 1;
+    for (auto id = root + 1; id-- > 0;) {
+        auto const& node = nodes[id];
+        if (uses[id] == 0 || arity(node.op) == 0) {
+            continue;
+        }
+        ++uses[node.lhs];
+        if (arity(node.op) >= 2) {
+            ++uses[node.rhs];
+        }
+        if (arity(node.op) == 3) {
+            ++uses[node.extra];
+        }
+    }
+    return uses;
+}
+
+struct Estimate {
+    // Size of the value
+    std::size_t limbs;
+    // Limb operations needed to compute it from its operands
+    std::size_t cost;
+};
+
+Estimate estimate(Operation op, std::size_t lhs, std::size_t rhs,
+                  std::size_t extra) {
+    switch (op) {
+    case Operation::Negate:
+        return {lhs, lhs};
+    case Operation::Square:
+        return {std::min(2 * lhs, MAX_LIMBS), lhs * lhs};
+    case Operation::Add:
+    case Operation::Substract: {
+        auto const limbs = std::min(std::max(lhs, rhs) + 1, MAX_LIMBS);
+        return {limbs, limbs};
+    }
+    case Operation::Multiply:
+        return {std::min(lhs + rhs, MAX_LIMBS), lhs * rhs};
+    case Operation::Divide: {
+        auto const quotient = lhs < rhs ? 1 : lhs - rhs + 1;
+        return {quotient, quotient * rhs};
+    }
+    case Operation::PowMod:
+        // A pair of products the size of the modulus per bit of the exponent,
+        // which overflows for large enough operands
+        return {extra, saturating_multiply(2 * 64 * rhs, extra * extra)};
+    case Operation::Literal:
+    case Operation::Variable:
+        break;
+    }
+
+    assert(false);
+    return {0, 0};
+}
+
+} // namespace
+
+BigNum evaluate(Ast const& ast, NodeId root,
+               std::span<BigNum const> variables) {
+    auto const nodes = ast.nodes();
+    assert(root < nodes.size());
+
+    if (arity(nodes[root].op) == 0) {
+        return leaf(ast, nodes[root], variables);
+    }
+
+    auto uses = count_uses(nodes, root);
+    std::vector<BigNum> values(root + 1);
+
+    // Hand over a computed value on its last use, a reference otherwise
+    auto const with_operand = [&](NodeId id, auto&& function) {
+        auto const& node = nodes[id];
+        if (arity(node.op) == 0) {
+            return function(leaf(ast, node, variables));
+        }
+        if (--uses[id] == 0) {
+            return function(std::move(values[id]));
+        }
+        return function(std::as_const(values[id]));
+    };
+
+    // Operands come first, so a single bottom-up sweep suffices
+    for (NodeId id = 0; id <= root; ++id) {
+        auto const& node = nodes[id];
+        if (uses[id] == 0 || arity(node.op) == 0) {
+            continue;
+        }
+        values[id] = compute(node, with_operand);
+    }
+
+    return std::move(values[root]);
+}
+
+BigNum evaluate(Ast const& ast, NodeId root,
+               std::span<BigNum const> variables, parallel::ThreadPool& pool) {
+    auto const nodes = ast.nodes();
+    assert(root < nodes.size());
+
+    if (arity(nodes[root].op) == 0) {
+        return leaf(ast, nodes[root], variables);
+    }
+
+    auto const uses = count_uses(nodes, root);
+
+    // Estimate the cost of each needed node from the size of its operands
+    std::vector<Estimate> estimates(root + 1, {0, 0});
+    bool worth_it = false;
+    for (NodeId id = 0; id <= root; ++id) {
+        auto const& node = nodes[id];
+        if (uses[id] == 0) {
+            continue;
+        }
+        if (arity(node.op) == 0) {
+            auto const limbs = leaf(ast, node, variables).limb_count();
+            estimates[id] = {limbs, 0};
+            continue;
+        }
+
+        auto const rhs = arity(node.op) >= 2 ? node.rhs : node.lhs;
+        auto const extra = arity(node.op) == 3 ? node.extra : node.lhs;
+        estimates[id]
+            = estimate(node.op, estimates[node.lhs].limbs,
+                       estimates[rhs].limbs, estimates[extra].limbs);
+        worth_it = worth_it || estimates[id].cost >= PARALLEL_GRAIN;
+    }
+
+    if (!worth_it) {
+        return evaluate(ast, root, variables);
+    }
+
+    // Computed operations using each computed node, in a flattened adjacency
+    // list, and the number of such operands each of them is waiting on
+    std::vector<std::size_t> offsets(root + 2, 0);
+    std::vector<std::atomic<std::size_t>> waiting(root + 1);
+    auto const for_each_operand = [&](NodeId id, auto&& function) {
+        auto const& node = nodes[id];
+        if (uses[id] == 0 || arity(node.op) == 0) {
+            return;
+        }
+        auto const operands = std::array{node.lhs, node.rhs, node.extra};
+        for (auto operand : std::span(operands).first(arity(node.op))) {
+            if (arity(nodes[operand].op) != 0) {
+                function(operand);
+            }
+        }
+    };
+    for (NodeId id = 0; id <= root; ++id) {
+        for_each_operand(id, [&](NodeId operand) {
+            ++offsets[operand + 1];
+            ++waiting[id];
+        });
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<NodeId> users(offsets.back());
+    {
+        auto next = offsets;
+        for (NodeId id = 0; id <= root; ++id) {
+            for_each_operand(id, [&](NodeId operand) {
+                users[next[operand]++] = id;
+            });
+        }
+    }
+
+    std::vector<BigNum> values(root + 1);
+    std::vector<std::atomic<std::size_t>> remaining(root + 1);
+    for (NodeId id = 0; id <= root; ++id) {
+        remaining[id] = uses[id];
+    }
+
+    // A value with a single use can be handed over, a shared one is released
+    // once all of its users are done with it, as they may run concurrently
+    auto const with_operand = [&](NodeId id, auto&& function) {
+        auto const& node = nodes[id];
+        if (arity(node.op) == 0) {
+            return function(leaf(ast, node, variables));
+        }
+        if (uses[id] == 1) {
+            return function(std::move(values[id]));
+        }
+        auto res = function(std::as_const(values[id]));
+        if (--remaining[id] == 0) {
+            values[id] = BigNum();
+        }
+        return res;
+    };
+
+    std::atomic<std::size_t> outstanding = 0;
+    std::atomic<bool> failed = false;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    // Compute the given nodes, then the cheap ones they make ready, queueing
+    // the expensive ones to let idle workers steal them
+    std::function<void(std::vector<NodeId>)> run;
+    auto const schedule = [&](NodeId id) {
+        ++outstanding;
+        pool.submit([&run, id] { run({id}); });
+    };
+    run = [&](std::vector<NodeId> stack) {
+        try {
+            while (!stack.empty() && !failed) {
+                auto const id = stack.back();
+                stack.pop_back();
+                values[id] = compute(nodes[id], with_operand);
+
+                for (auto i = offsets[id]; i < offsets[id + 1]; ++i) {
+                    auto const user = users[i];
+                    if (--waiting[user] != 0) {
+                        continue;
+                    }
+                    if (estimates[user].cost < PARALLEL_GRAIN) {
+                        stack.push_back(user);
+                    } else {
+                        schedule(user);
+                    }
+                }
+            }
+        } catch (...) {
+            std::lock_guard lock(error_mutex);
+            if (!failed.exchange(true)) {
+                error = std::current_exception();
+            }
+        }
+        --outstanding;
+    };
+
+    // Start from the operations on leaves, and help until all are done
+    std::vector<NodeId> ready;
+    for (NodeId id = 0; id <= root; ++id) {
+        if (uses[id] == 0 || arity(nodes[id].op) == 0 || waiting[id] != 0) {
+            continue;
+        }
+        if (estimates[id].cost < PARALLEL_GRAIN) {
+            ready.push_back(id);
+        } else {
+            schedule(id);
+        }
+    }
+    ++outstanding;
+    run(std::move(ready));
+    pool.wait([&] { return outstanding == 0; });
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return std::move(values[root]);
+}
+
+} // namespace abacus::ast
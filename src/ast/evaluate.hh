@@ -0,0 +1,27 @@
+#pragma once
+
+#include <span>
+
+#include "ast.hh"
+
+#include "bignum/bignum.hh"
+#include "parallel/thread-pool.hh"
+
+namespace abacus::ast {
+
+// Compute the value of the expression rooted at `root`, in a single sweep over
+// the arena, with `variables` holding the values of the AST's variables.
+// Intermediate values are released, or re-used by the next operation, as soon
+// as they are no longer needed.
+bignum::BigNum evaluate(Ast const& ast, NodeId root,
+                        std::span<bignum::BigNum const> variables = {});
+
+// Same as above, computing independent operations concurrently on `pool`. Only
+// operations estimated to be expensive enough from the size of their operands
+// are queued, cheap ones being computed by the thread which made them ready,
+// and falling back to the above if there are no expensive ones at all.
+bignum::BigNum evaluate(Ast const& ast, NodeId root,
+                        std::span<bignum::BigNum const> variables,
+                        parallel::ThreadPool& pool);
+
+} // namespace abacus::ast
@@ -0,0 +1,419 @@
+#include "optimize.hh"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+
+#include "bignum/bignum.hh"
+
+namespace abacus::ast {
+
+using bignum::BigNum;
+
+namespace {
+
+struct NodeHash {
+    std::size_t operator()(Node const& node) const {
+        auto const hash = std::hash<NodeId>{};
+        auto res = std::hash<int>{}(int(node.op));
+        res = res * 31 + hash(node.lhs);
+        res = res * 31 + hash(node.rhs);
+        res = res * 31 + hash(node.extra);
+        return res;
+    }
+};
+
+// Folding operations on larger values would just move the work from the
+// evaluation, and keep every intermediate value alive in the arena
+bool is_foldable(BigNum const& num) {
+    static auto const max = pow(BigNum(2), BigNum(256));
+    static auto const min = -max;
+    return min < num && num < max;
+}
+
+// Mark the nodes which `root` depends on, going top-down
+std::vector<bool> find_needed(Ast const& ast, NodeId root) {
+    auto const nodes = ast.nodes();
+    assert(root < nodes.size());
+
+    std::vector<bool> needed(root + 1, false);
+    needed[root] = true;
+    for (auto id = root + 1; id-- > 0;) {
+        auto const& node = nodes[id];
+        if (!needed[id] || arity(node.op) == 0) {
+            continue;
+        }
+        needed[node.lhs] = true;
+        if (arity(node.op) >= 2) {
+            needed[node.rhs] = true;
+        }
+        if (arity(node.op) == 3) {
+            needed[node.extra] = true;
+        }
+    }
+
+    return needed;
+}
+
+// Copy only the nodes which `root` depends on, returning the new root
+NodeId prune(Ast const& ast, NodeId root, Ast& res) {
+    auto const nodes = ast.nodes();
+    auto const needed = find_needed(ast, root);
+
+    // Keep all variables, so that their indices do not change
+    for (auto const& name : ast.variables()) {
+        res.declare(name);
+    }
+
+    std::vector<NodeId> pruned(root + 1);
+    for (NodeId id = 0; id <= root; ++id) {
+        auto const& node = nodes[id];
+        if (!needed[id]) {
+            continue;
+        }
+
+        switch (arity(node.op)) {
+        case 0:
+            pruned[id] = node.op == Operation::Literal
+                             ? res.literal(ast.value(node))
+                             : res.variable(ast.name(node));
+            break;
+        case 1:
+            pruned[id] = res.unary(node.op, pruned[node.lhs]);
+            break;
+        case 2:
+            pruned[id]
+                = res.binary(node.op, pruned[node.lhs], pruned[node.rhs]);
+            break;
+        case 3:
+            pruned[id] = res.ternary(node.op, pruned[node.lhs],
+                                     pruned[node.rhs], pruned[node.extra]);
+            break;
+        }
+    }
+
+    return pruned[root];
+}
+
+bool is_commutative(Operation op) {
+    return op == Operation::Add || op == Operation::Multiply;
+}
+
+class Optimizer {
+public:
+    explicit Optimizer(Ast const& ast) : ast_(ast) {}
+
+    NodeId rewrite(NodeId root);
+
+    Ast const& result() const {
+        return res_;
+    }
+
+private:
+    NodeId literal(BigNum value);
+    NodeId variable(std::string const& name);
+    NodeId make(Operation op, NodeId lhs, NodeId rhs = 0, NodeId extra = 0);
+    std::optional<NodeId> simplify(Operation op, NodeId lhs, NodeId rhs,
+                                   NodeId extra);
+    std::optional<NodeId> fold(Operation op, NodeId lhs, NodeId rhs,
+                               NodeId extra);
+
+    bool is_literal(NodeId id) const;
+    bool is_literal(NodeId id, BigNum const& value) const;
+    bool is_negation(NodeId id) const;
+
+    Ast const& ast_;
+    Ast res_{};
+    std::unordered_map<BigNum, NodeId> literals_{};
+    std::unordered_map<Node, NodeId, NodeHash> nodes_{};
+    // Whether evaluating each node of `res_` might throw
+    std::vector<bool> fallible_{};
+};
+
+NodeId Optimizer::rewrite(NodeId root) {
+    auto const nodes = ast_.nodes();
+    auto const needed = find_needed(ast_, root);
+
+    for (auto const& name : ast_.variables()) {
+        res_.declare(name);
+    }
+
+    // Operands come first, so they are always rewritten before their users
+    std::vector<NodeId> rewritten(root + 1);
+    for (NodeId id = 0; id <= root; ++id) {
+        auto const& node = nodes[id];
+        if (!needed[id]) {
+            continue;
+        }
+
+        switch (arity(node.op)) {
+        case 0:
+            rewritten[id] = node.op == Operation::Literal
+                                ? literal(ast_.value(node))
+                                : variable(ast_.name(node));
+            break;
+        case 1:
+            rewritten[id] = make(node.op, rewritten[node.lhs]);
+            break;
+        case 2:
+            rewritten[id]
+                = make(node.op, rewritten[node.lhs], rewritten[node.rhs]);
+            break;
+        case 3:
+            rewritten[id] = make(node.op, rewritten[node.lhs],
+                                 rewritten[node.rhs], rewritten[node.extra]);
+            break;
+        }
+    }
+
+    return rewritten[root];
+}
+
+NodeId Optimizer::literal(BigNum value) {
+    if (auto const it = literals_.find(value); it != literals_.end()) {
+        return it->second;
+    }
+
+    auto const id = res_.literal(value);
+    literals_.emplace(std::move(value), id);
+    fallible_.push_back(false);
+    return id;
+}
+
+NodeId Optimizer::variable(std::string const& name) {
+    auto const node = Node{Operation::Variable, res_.declare(name)};
+    if (auto const it = nodes_.find(node); it != nodes_.end()) {
+        return it->second;
+    }
+
+    auto const id = res_.variable(name);
+    nodes_.emplace(node, id);
+    // It may not be bound when evaluating
+    fallible_.push_back(true);
+    return id;
+}
+
+NodeId Optimizer::make(Operation op, NodeId lhs, NodeId rhs, NodeId extra) {
+    if (auto const simplified = simplify(op, lhs, rhs, extra)) {
+        return *simplified;
+    }
+
+    if (is_commutative(op) && rhs < lhs) {
+        std::swap(lhs, rhs);
+    }
+
+    auto const node = Node{op, lhs, arity(op) >= 2 ? rhs : 0,
+                           arity(op) == 3 ? extra : 0};
+    if (auto const it = nodes_.find(node); it != nodes_.end()) {
+        return it->second;
+    }
+
+    NodeId id;
+    switch (arity(op)) {
+    case 1:
+        id = res_.unary(op, lhs);
+        break;
+    case 2:
+        id = res_.binary(op, lhs, rhs);
+        break;
+    default:
+        id = res_.ternary(op, lhs, rhs, extra);
+        break;
+    }
+    nodes_.emplace(node, id);
+
+    auto fallible = fallible_[lhs];
+    if (op == Operation::Divide) {
+        fallible = fallible || fallible_[rhs] || !is_literal(rhs)
+                   || is_literal(rhs, BigNum(0));
+    } else if (op == Operation::PowMod) {
+        fallible = fallible || fallible_[rhs] || fallible_[extra]
+                   || !is_literal(extra) || is_literal(extra, BigNum(0));
+    } else if (arity(op) == 2) {
+        fallible = fallible || fallible_[rhs];
+    }
+    fallible_.push_back(fallible);
+
+    return id;
+}
+
+std::optional<NodeId> Optimizer::simplify(Operation op, NodeId lhs,
+                                          NodeId rhs, NodeId extra) {
+    if (auto const folded = fold(op, lhs, rhs, extra)) {
+        return folded;
+    }
+
+    auto const zero = BigNum(0);
+    auto const one = BigNum(1);
+    auto const minus_one = BigNum(-1);
+    auto const operand = [&](NodeId id) { return res_.node(id).lhs; };
+
+    switch (op) {
+    case Operation::Literal:
+    case Operation::Variable:
+        break;
+    case Operation::Negate:
+        if (is_negation(lhs)) {
+            return operand(lhs);
+        }
+        break;
+    case Operation::Square:
+        if (is_negation(lhs)) {
+            return make(Operation::Square, operand(lhs));
+        }
+        break;
+    case Operation::Add:
+        if (is_literal(lhs, zero)) {
+            return rhs;
+        }
+        if (is_literal(rhs, zero)) {
+            return lhs;
+        }
+        if (is_negation(rhs)) {
+            return make(Operation::Substract, lhs, operand(rhs));
+        }
+        if (is_negation(lhs)) {
+            return make(Operation::Substract, rhs, operand(lhs));
+        }
+        break;
+    case Operation::Substract:
+        if (is_literal(rhs, zero)) {
+            return lhs;
+        }
+        if (is_literal(lhs, zero)) {
+            return make(Operation::Negate, rhs);
+        }
+        if (lhs == rhs && !fallible_[lhs]) {
+            return literal(zero);
+        }
+        if (is_negation(rhs)) {
+            return make(Operation::Add, lhs, operand(rhs));
+        }
+        break;
+    case Operation::Multiply:
+        if (is_literal(lhs, one)) {
+            return rhs;
+        }
+        if (is_literal(rhs, one)) {
+            return lhs;
+        }
+        if (is_literal(lhs, minus_one)) {
+            return make(Operation::Negate, rhs);
+        }
+        if (is_literal(rhs, minus_one)) {
+            return make(Operation::Negate, lhs);
+        }
+        if ((is_literal(lhs, zero) && !fallible_[rhs])
+            || (is_literal(rhs, zero) && !fallible_[lhs])) {
+            return literal(zero);
+        }
+        if (lhs == rhs) {
+            return make(Operation::Square, lhs);
+        }
+        if (is_negation(lhs) && is_negation(rhs)) {
+            return make(Operation::Multiply, operand(lhs), operand(rhs));
+        }
+        break;
+    case Operation::Divide:
+        if (is_literal(rhs, one)) {
+            return lhs;
+        }
+        if (is_literal(rhs, minus_one)) {
+            return make(Operation::Negate, lhs);
+        }
+        break;
+    case Operation::PowMod:
+        // The sign of the modulus does not matter
+        if (is_negation(extra)) {
+            return make(Operation::PowMod, lhs, rhs, operand(extra));
+        }
+        break;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<NodeId> Optimizer::fold(Operation op, NodeId lhs, NodeId rhs,
+                                      NodeId extra) {
+    if (!is_literal(lhs) || (arity(op) >= 2 && !is_literal(rhs))
+        || (arity(op) == 3 && !is_literal(extra))) {
+        return std::nullopt;
+    }
+
+    auto const& lhs_value = res_.value(res_.node(lhs));
+    if (!is_foldable(lhs_value)) {
+        return std::nullopt;
+    }
+
+    if (arity(op) == 1) {
+        return literal(op == Operation::Negate ? -lhs_value
+                                               : lhs_value * lhs_value);
+    }
+
+    auto const& rhs_value = res_.value(res_.node(rhs));
+    if (!is_foldable(rhs_value)) {
+        return std::nullopt;
+    }
+
+    switch (op) {
+    case Operation::Add:
+        return literal(lhs_value + rhs_value);
+    case Operation::Substract:
+        return literal(lhs_value - rhs_value);
+    case Operation::Multiply:
+        return literal(lhs_value * rhs_value);
+    case Operation::Divide:
+        // Keep the error for evaluation time
+        if (rhs_value.is_zero()) {
+            return std::nullopt;
+        }
+        return literal(lhs_value / rhs_value);
+    case Operation::PowMod: {
+        auto const& modulus = res_.value(res_.node(extra));
+        // Results are below the modulus, whatever the size of the exponent
+        if (!is_foldable(modulus) || modulus.is_zero()) {
+            return std::nullopt;
+        }
+        return literal(pow_mod(lhs_value, rhs_value, modulus));
+    }
+    case Operation::Literal:
+    case Operation::Variable:
+    case Operation::Negate:
+    case Operation::Square:
+        break;
+    }
+
+    return std::nullopt;
+}
+
+bool Optimizer::is_literal(NodeId id) const {
+    return res_.node(id).op == Operation::Literal;
+}
+
+bool Optimizer::is_literal(NodeId id, BigNum const& value) const {
+    return is_literal(id) && res_.value(res_.node(id)) == value;
+}
+
+bool Optimizer::is_negation(NodeId id) const {
+    return res_.node(id).op == Operation::Negate;
+}
+
+} // namespace
+
+NodeId optimize(Ast& ast, NodeId root) {
+    Optimizer optimizer(ast);
+    auto const rewritten = optimizer.rewrite(root);
+
+    // Simplifications leave unused nodes behind
+    Ast res;
+    auto const res_root = prune(optimizer.result(), rewritten, res);
+    ast = std::move(res);
+    return res_root;
+}
+
+} // namespace abacus::ast
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "ast.hh"
+
+namespace abacus::ast {
+
+// Rewrite the expression rooted at `root` into a DAG in which identical
+// sub-expressions are shared, so that they are only evaluated once. Along the
+// way, identities such as `e * 1` or `--e` are simplified, `e * e` becomes a
+// squaring, and operations on small literals are folded. Operations which
+// could fail, such as divisions by zero, are never removed. Returns the new
+// root in the rewritten `ast`.
+NodeId optimize(Ast& ast, NodeId root);
+
+} // namespace abacus::ast
@@ -1,21 +1,32 @@
 #include "bignum.hh"
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
 #include <iostream>
-#include <iterator>
+#include <limits>
 #include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include <cassert>
-#include <cmath>
+#include <cctype>
+
+#include "kernels.hh"
+#include "stats.hh"
+#include "tuning.hh"
 
 namespace abacus::bignum {
 
-using digits_type = std::vector<std::uint8_t>;
+using kernels::digit_type;
+using kernels::digits_type;
+using kernels::DIGIT_BITS;
 
 namespace {
 
-auto static constexpr BASE = 10;
-
 bool do_less_than(digits_type const& lhs, digits_type const& rhs) {
     if (lhs.size() != rhs.size()) {
         return lhs.size() < rhs.size();
@@ -31,30 +42,22 @@ void trim_leading_zeros(digits_type& num) {
     num.erase(it.base(), num.end());
 }
 
-std::ostream& do_dump(digits_type const& num, std::ostream& out) {
-    std::copy(num.rbegin(), num.rend(), std::ostream_iterator<int>(out));
-    return out;
+std::size_t bit_length(digits_type const& num) {
+    if (num.size() == 0) {
+        return 0;
+    }
+
+    return num.size() * DIGIT_BITS - std::countl_zero(num.back());
 }
 
 // More optimised than full-on div_mod
-digits_type do_halve(digits_type num) {
+void do_halve(digits_type& num) {
     assert(num.size() != 0);
+    stats::Scope counted(stats::Kernel::Halve, num.size());
 
-    int carry = 0;
-    for (auto i = num.rbegin(); i != num.rend(); ++i) {
-        auto const was_odd = (*i % 2) == 1;
-        *i /= 2;
-        *i += carry;
-        if (was_odd) {
-            carry = BASE / 2;
-        } else {
-            carry = 0;
-        }
-    }
+    kernels::shift_right(num, num, 1);
 
     trim_leading_zeros(num);
-
-    return num;
 }
 
 bool is_odd(digits_type const& num) {
@@ -62,80 +65,86 @@ bool is_odd(digits_type const& num) {
         return false;
     }
 
-    return (num.front() % 2) == 1;
+    return (num.front() & 1) == 1;
 }
 
-digits_type do_addition(digits_type const& lhs, digits_type const& rhs) {
-    int carry = 0;
-    digits_type res;
-
-    auto it1 = lhs.begin();
-    auto it2 = rhs.begin();
-
-    auto const end1 = lhs.end();
-    auto const end2 = rhs.end();
+// The helpers below compute their result in `res`, which may alias either
+// operand, reusing its capacity when possible
 
-    while (it1 != end1 && it2 != end2) {
-        int addition = *it1 + *it2 + carry;
-        carry = addition / BASE;
-        res.push_back(addition % BASE);
-        ++it1;
-        ++it2;
-    }
-
-    auto leftover = [=]() {
-        if (it1 != end1) {
-            return std::span(it1, end1);
-        }
-        return std::span(it2, end2);
-    }();
+void do_addition(digits_type& res, digits_type const& lhs,
+                 digits_type const& rhs) {
+    auto const& longest = lhs.size() < rhs.size() ? rhs : lhs;
+    auto const& shortest = lhs.size() < rhs.size() ? lhs : rhs;
 
-    for (auto value : leftover) {
-        int addition = value + carry;
-        carry = addition / BASE;
-        res.push_back(addition % BASE);
+    if (&res != &longest) {
+        // Make room for the carry up front, to allocate at most once
+        res.reserve(longest.size() + 1);
+        res.resize(longest.size());
     }
 
+    auto const carry = kernels::add(res, longest, shortest);
     if (carry != 0) {
         res.push_back(carry);
     }
-
-    return res;
 }
 
-digits_type do_substraction(digits_type const& lhs, digits_type const& rhs) {
-    assert(!do_less_than(lhs, rhs));
+// Compute the magnitude of `lhs - rhs`, returning whether it was negative
+bool do_substraction(digits_type& res, digits_type const& lhs,
+                     digits_type const& rhs) {
+    auto const flipped = do_less_than(lhs, rhs);
+    auto const& larger = flipped ? rhs : lhs;
+    auto const& smaller = flipped ? lhs : rhs;
+
+    if (&res != &larger) {
+        res.resize(larger.size());
+    }
 
-    digits_type complement;
-    auto const take_complement = [](auto num) { return BASE - 1 - num; };
-    std::transform(lhs.begin(), lhs.end(), std::back_inserter(complement),
-                   take_complement);
+    [[maybe_unused]] auto const borrow
+        = kernels::substract(res, larger, smaller);
+    assert(borrow == 0);
 
-    complement = do_addition(complement, rhs);
+    trim_leading_zeros(res);
 
-    std::transform(complement.begin(), complement.end(), complement.begin(),
-                   take_complement);
+    return flipped;
+}
 
-    trim_leading_zeros(complement);
+void do_square(digits_type& res, digits_type const& num) {
+    if (&res != &num) {
+        res.resize(2 * num.size());
+        kernels::square(res, num);
+    } else {
+        digits_type square(2 * num.size());
+        kernels::square(square, num);
+        res = std::move(square);
+    }
 
-    return complement;
+    trim_leading_zeros(res);
 }
 
-digits_type do_multiplication(digits_type const& lhs, digits_type const& rhs) {
-    digits_type res(lhs.size() + rhs.size());
+void do_multiplication(digits_type& res, digits_type const& lhs,
+                       digits_type const& rhs) {
+    auto const size = lhs.size() + rhs.size();
 
-    for (std::size_t i = 0; i < lhs.size(); ++i) {
-        int carry = 0;
-        for (std::size_t j = 0; j < rhs.size(); ++j) {
-            int multiplication = lhs[i] * rhs[j];
-            res[i + j] += multiplication + carry;
-            carry = res[i + j] / BASE;
-            res[i + j] %= BASE;
-        }
-        res[i + rhs.size()] += carry;
+    if (&lhs == &rhs) {
+        do_square(res, lhs);
+        return;
     }
 
-    return res;
+    if (&res != &lhs && &res != &rhs) {
+        res.resize(size);
+        kernels::multiply(res, lhs, rhs);
+    } else if (std::min(lhs.size(), rhs.size()) < thresholds().karatsuba) {
+        // Short products are quadratic anyway, compute them in place
+        auto const& other = &res == &lhs ? rhs : lhs;
+        res.resize(size);
+        kernels::multiply_in_place(res, other);
+    } else {
+        digits_type product(size);
+        kernels::multiply(product, lhs, rhs);
+        res = std::move(product);
+    }
+
+    trim_leading_zeros(res);
 }
 
 std::pair<digits_type, digits_type> do_div_mod(digits_type const& lhs,
@@ -144,69 +153,263 @@ std::pair<digits_type, digits_type> do_div_mod(digits_type const& lhs,
         throw std::invalid_argument("attempt to divide by zero");
     }
 
-    digits_type multiple = rhs;
-    digits_type rank;
-    rank.push_back(1);
-
-    while (!do_less_than(lhs, multiple)) {
-        multiple = do_addition(multiple, multiple);
-        rank = do_addition(rank, rank);
+    if (do_less_than(lhs, rhs)) {
+        return std::make_pair(digits_type(), lhs);
     }
 
-    digits_type quotient;
-    digits_type remainder = lhs;
+    digits_type quotient(lhs.size() - rhs.size() + 1);
+    digits_type remainder(rhs.size());
+    kernels::div_mod(quotient, remainder, lhs, rhs);
 
-    while (!do_less_than(remainder, rhs)) {
-        while (do_less_than(remainder, multiple)) {
-            multiple = do_halve(multiple);
-            rank = do_halve(rank);
-        }
+    trim_leading_zeros(quotient);
+    trim_leading_zeros(remainder);
 
-        assert(!do_less_than(multiple, rhs));
+    return std::make_pair(std::move(quotient), std::move(remainder));
+}
+
+bool test_bit(digits_type const& num, std::size_t bit) {
+    return (num[bit / DIGIT_BITS] >> (bit % DIGIT_BITS)) & 1;
+}
+
+// Number of bits of the exponent handled by each multiplication of the sliding
+// window exponentiation: larger windows mean fewer multiplications, but more
+// odd powers of the base to compute up front
+std::size_t window_size(digits_type const& base, std::size_t exponent_bits) {
+    // Minimizes the table's size plus the expected multiplications, for the
+    // exponents of at most one limb accepted by `do_pow`
+    std::size_t res = 1 + (exponent_bits > 6) + (exponent_bits > 24);
 
-        quotient = do_addition(quotient, rank);
-        remainder = do_substraction(remainder, multiple);
+    if (base.size() == 1) {
+        // Multiplying by a single limb is cheap, keep the table in one
+        while (res > 1 && bit_length(base) * ((1u << res) - 1) > DIGIT_BITS) {
+            --res;
+        }
+    } else if (base.size() < thresholds().karatsuba) {
+        // Quadratic products by larger powers cost as much as they save
+        res = 1;
     }
 
-    return std::make_pair(quotient, remainder);
+    return res;
 }
 
-digits_type do_pow(digits_type lhs, digits_type rhs) {
+// Raise to a power through a sliding window over the bits of the exponent,
+// with special cases for 0, 1, and powers of two. Trailing zero bits of the
+// base are only shifted back in at the end, which makes `10^N` a power of 5
+digits_type do_pow(digits_type const& lhs, digits_type const& rhs) {
     assert(rhs.size() != 0);
 
-    auto original = lhs;
+    if (lhs.size() == 0 || (lhs.size() == 1 && lhs[0] == 1)) {
+        return lhs;
+    }
+
+    // Split the base as `odd * 2^shift`
+    auto const zero_limbs = std::size_t(
+        std::find_if(lhs.begin(), lhs.end(), [](auto v) { return v != 0; })
+        - lhs.begin());
+    auto const zero_bits = unsigned(std::countr_zero(lhs[zero_limbs]));
+    auto const shift = zero_limbs * DIGIT_BITS + zero_bits;
+    digits_type odd(lhs.begin() + zero_limbs, lhs.end());
+    if (zero_bits != 0) {
+        kernels::shift_right(odd, odd, zero_bits);
+        trim_leading_zeros(odd);
+    }
+
+    // Bound the size of the result, to allocate it once
+    auto const exponent = rhs[0];
+    auto const max = std::numeric_limits<std::size_t>::max() / DIGIT_BITS;
+    if (rhs.size() > 1 || exponent > max / bit_length(lhs)) {
+        throw std::invalid_argument("exponent is too large");
+    }
+    auto const limbs = (bit_length(lhs) * exponent) / DIGIT_BITS + 3;
+
+    digits_type res, spare;
+    res.reserve(limbs);
+
+    // Write each product in the spare storage, then swap it in
+    auto const square = [&] {
+        spare.resize(2 * res.size());
+        kernels::square(spare, res);
+        trim_leading_zeros(spare);
+        std::swap(res, spare);
+    };
+    auto const multiply = [&](digits_type const& factor) {
+        if (factor.size() == 1) {
+            auto const carry = kernels::multiply_digit(res, res, factor[0]);
+            if (carry != 0) {
+                res.push_back(carry);
+            }
+            return;
+        }
+        spare.resize(res.size() + factor.size());
+        kernels::multiply(spare, res, factor);
+        trim_leading_zeros(spare);
+        std::swap(res, spare);
+    };
+
+    if (odd.size() == 1 && odd[0] == 1) {
+        res.push_back(1);
+    } else if (bit_length(odd) * exponent <= DIGIT_BITS) {
+        // The odd part of the result fits in a single limb
+        digit_type power = 1;
+        for (auto base = odd[0], bits = exponent; bits != 0; bits >>= 1) {
+            if (bits & 1) {
+                power *= base;
+            }
+            base *= base;
+        }
+        res.push_back(power);
+    } else {
+        spare.reserve(limbs);
+
+        auto const bits = bit_length(rhs);
+        auto const window = window_size(odd, bits);
+
+        // Odd powers `odd^1, odd^3, ..., odd^(2^window - 1)`
+        std::vector<digits_type> powers(std::size_t(1) << (window - 1));
+        powers[0] = odd;
+        if (powers.size() > 1) {
+            digits_type odd_square;
+            do_square(odd_square, odd);
+            for (std::size_t i = 1; i < powers.size(); ++i) {
+                do_multiplication(powers[i], powers[i - 1], odd_square);
+            }
+        }
 
-    while (rhs.size() != 0 && !(rhs.size() == 1 && rhs.front() == 1)) {
-        lhs = do_multiplication(lhs, lhs);
-        if (is_odd(rhs)) {
-            lhs = do_multiplication(lhs, original);
+        // Consume the exponent from its top bit, each window ending in a one
+        for (auto top = bits; top > 0;) {
+            if (!test_bit(rhs, top - 1)) {
+                square();
+                --top;
+                continue;
+            }
+
+            auto low = top > window ? top - window : 0;
+            while (!test_bit(rhs, low)) {
+                ++low;
+            }
+            std::size_t value = 0;
+            for (auto bit = top; bit-- > low;) {
+                value = 2 * value + test_bit(rhs, bit);
+            }
+
+            if (res.size() == 0) {
+                res.assign(powers[value / 2].begin(), powers[value / 2].end());
+            } else {
+                for (auto bit = low; bit < top; ++bit) {
+                    square();
+                }
+                multiply(powers[value / 2]);
+            }
+            top = low;
         }
-        rhs = do_halve(rhs);
     }
 
-    return lhs;
+    // Shift the powers of two back in, as whole limbs then bits
+    if (shift != 0) {
+        auto const total = shift * exponent;
+        auto const limb_shift = total / DIGIT_BITS;
+        auto const bit_shift = unsigned(total % DIGIT_BITS);
+        auto const size = res.size();
+
+        res.resize(size + limb_shift + 1);
+        std::copy_backward(res.begin(), res.begin() + size,
+                           res.begin() + size + limb_shift);
+        std::fill(res.begin(), res.begin() + limb_shift, 0);
+        auto const low = kernels::digits_span(res).subspan(limb_shift, size);
+        res.back()
+            = bit_shift == 0 ? 0 : kernels::shift_left(low, low, bit_shift);
+        trim_leading_zeros(res);
+    }
+
+    return res;
 }
 
 digits_type do_sqrt(digits_type const& num) {
-    digits_type one;
-    one.push_back(1);
-    digits_type max = num;
-    digits_type min = do_addition(max, one);
-    min = do_halve(min);
+    // Start from a power of two above the root, from which Newton's iteration
+    // decreases monotonically, instead of halving our way down from `num`
+    auto const shift = (bit_length(num) + 1) / 2;
+    digits_type max(shift / DIGIT_BITS + 1);
+    max.back() = digit_type(1) << (shift % DIGIT_BITS);
+
+    digits_type min;
+    std::tie(min, std::ignore) = do_div_mod(num, max);
+    do_addition(min, min, max);
+    do_halve(min);
 
     while (do_less_than(min, max)) {
         max = min;
         std::tie(min, std::ignore) = do_div_mod(num, max);
-        min = do_addition(min, max);
-        min = do_halve(min);
+        do_addition(min, min, max);
+        do_halve(min);
     }
 
     return max;
 }
 
+// `log10(2)` and `log2(10) - 3`, as 128-bit fixed point fractions, most
+// significant limb first
+constexpr digit_type LOG10_2[] = {0x4d104d427de7fbcc, 0x47c4acd605be48bc};
+constexpr digit_type LOG2_10[] = {0x5269e12f346e2bf9, 0x24afdbfd36bf6d33};
+
+// `num * (integer + fraction)`, as its integer part and the top limb of its
+// fractional part
+std::pair<std::size_t, digit_type> fixed_multiply(std::size_t num,
+                                                  std::size_t integer,
+                                                  digit_type const* fraction) {
+    using kernels::double_digit_type;
+
+    auto const low = (double_digit_type(num) * fraction[1]) >> DIGIT_BITS;
+    auto const product = double_digit_type(num) * fraction[0] + low;
+    return {num * integer + std::size_t(product >> DIGIT_BITS),
+            digit_type(product)};
+}
+
+// The top bits of the number, as a value in `[1, 2)`
+double mantissa(digits_type const& num) {
+    auto const shift = std::countl_zero(num.back());
+    auto top = num.back() << shift;
+    if (shift != 0 && num.size() > 1) {
+        top |= num[num.size() - 2] >> (DIGIT_BITS - shift);
+    }
+    return std::ldexp(double(top), 1 - DIGIT_BITS);
+}
+
+// Number of decimal digits, from the bit length and the top limbs. Only
+// numbers within a relative `2^-40` of a power of ten need to compare to it.
+std::size_t decimal_length(digits_type const& num) {
+    assert(num.size() != 0);
+
+    // There is at most one power of ten in `[2^(bits - 1), 2^bits)`
+    auto const bits = bit_length(num);
+    auto const lower = fixed_multiply(bits - 1, 0, LOG10_2).first + 1;
+    auto const upper = fixed_multiply(bits, 0, LOG10_2).first + 1;
+    if (lower == upper) {
+        return lower;
+    }
+
+    // Which is `10^power = 2^(bits - 1) * 2^fraction`
+    auto const power = upper - 1;
+    auto const [exponent, fraction] = fixed_multiply(power, 3, LOG2_10);
+    if (exponent == bits - 1) {
+        auto const threshold = std::exp2(std::ldexp(double(fraction), -64));
+        auto const top = mantissa(num);
+        if (top > threshold * (1 + 0x1p-40)) {
+            return upper;
+        } else if (top < threshold * (1 - 0x1p-40)) {
+            return lower;
+        }
+    }
+
+    auto const ten = digits_type(1, 10);
+    auto const exponent_digits = digits_type(1, power);
+    return do_less_than(num, do_pow(ten, exponent_digits)) ? lower : upper;
+}
+
 } // namespace
 
 BigNum::BigNum(std::int64_t number) {
+    static_assert(std::is_same_v<decltype(digits_), digits_type>);
+
     if (number == 0) {
         return;
     }
@@ -217,15 +420,31 @@ BigNum::BigNum(std::int64_t number) {
         sign_ = 1;
     }
 
-    auto abs = static_cast<std::uint64_t>(std::abs(number));
-    do {
-        digits_.push_back(abs % BASE);
-        abs /= BASE;
-    } while (abs);
+    // Negate as unsigned to avoid overflowing on the minimum value
+    auto const abs = number < 0 ? -static_cast<std::uint64_t>(number)
+                                : static_cast<std::uint64_t>(number);
+    digits_.push_back(abs);
 
     assert(is_canonicalized());
 }
 
+BigNum::BigNum(std::string_view decimal) {
+    auto const negative = decimal.starts_with('-');
+    if (negative) {
+        decimal.remove_prefix(1);
+    }
+
+    auto const is_digit = [](char c) { return '0' <= c && c <= '9'; };
+    if (decimal.empty()
+        || !std::all_of(decimal.begin(), decimal.end(), is_digit)) {
+        throw std::invalid_argument("invalid decimal number");
+    }
+
+    digits_ = kernels::from_decimal(decimal);
+    sign_ = negative ? -1 : 1;
+    canonicalize();
+}
+
 std::ostream& BigNum::dump(std::ostream& out) const {
     if (is_zero()) {
         return out << '0';
@@ -235,7 +454,7 @@ std::ostream& BigNum::dump(std::ostream& out) const {
         out << '-';
     }
 
-    return do_dump(digits_, out);
+    return out << kernels::to_decimal(digits_);
 }
 
 std::istream& BigNum::read(std::istream& in) {
@@ -249,12 +468,12 @@ std::istream& BigNum::read(std::istream& in) {
         sign_ = 1;
     }
 
-    digits_type digits;
+    std::string decimal;
     while (std::isdigit(in.peek())) {
         parsed = true;
-        int digit = in.get() - '0';
-        if (digit != 0 || !leading) {
-            digits.push_back(digit);
+        char digit = in.get();
+        if (digit != '0' || !leading) {
+            decimal.push_back(digit);
             leading = false;
         }
     }
@@ -265,11 +484,11 @@ std::istream& BigNum::read(std::istream& in) {
 
     if (!parsed) {
         in.setstate(std::ios::failbit);
-    } else {
-        std::reverse(digits.begin(), digits.end());
-        digits_ = std::move(digits);
+        return in;
     }
 
+    digits_ = kernels::from_decimal(decimal);
+
     return in;
 }
 
@@ -279,61 +498,81 @@ void BigNum::flip_sign() {
     sign_ *= -1;
 }
 
-void BigNum::add(BigNum const& rhs) {
-    assert(is_canonicalized());
+void BigNum::add(BigNum const& lhs, BigNum const& rhs) {
+    assert(lhs.is_canonicalized());
     assert(rhs.is_canonicalized());
 
     if (rhs.is_zero()) {
+        *this = lhs;
         return;
     }
 
-    if (is_zero()) {
+    if (lhs.is_zero()) {
         *this = rhs;
         return;
     }
 
-    if (sign_ == rhs.sign_) {
-        digits_ = do_addition(digits_, rhs.digits_);
+    stats::Scope counted(stats::Kernel::Add, std::max(lhs.digits_.size(),
+                                                    rhs.digits_.size()));
+
+    if (lhs.sign_ == rhs.sign_) {
+        do_addition(digits_, lhs.digits_, rhs.digits_);
+        sign_ = lhs.sign_;
     } else {
-        bool flipped = do_less_than(digits_, rhs.digits_);
-        if (flipped) {
-            digits_ = do_substraction(rhs.digits_, digits_);
-        } else {
-            digits_ = do_substraction(digits_, rhs.digits_);
-        }
-        if (flipped) {
-            flip_sign();
-        }
+        auto const sign = lhs.sign_;
+        auto const flipped = do_substraction(digits_, lhs.digits_, rhs.digits_);
+        sign_ = flipped ? -sign : sign;
         canonicalize();
     }
 
     assert(is_canonicalized());
 }
 
-void BigNum::substract(BigNum const& rhs) {
-    assert(is_canonicalized());
+void BigNum::substract(BigNum const& lhs, BigNum const& rhs) {
+    assert(lhs.is_canonicalized());
     assert(rhs.is_canonicalized());
 
-    flip_sign();
-    add(rhs);
-    flip_sign();
+    if (rhs.is_zero()) {
+        *this = lhs;
+        return;
+    }
+
+    if (lhs.is_zero()) {
+        *this = rhs;
+        flip_sign();
+        return;
+    }
+
+    stats::Scope counted(stats::Kernel::Substract, std::max(lhs.digits_.size(),
+                                                          rhs.digits_.size()));
+
+    if (lhs.sign_ != rhs.sign_) {
+        do_addition(digits_, lhs.digits_, rhs.digits_);
+        sign_ = lhs.sign_;
+    } else {
+        auto const sign = lhs.sign_;
+        auto const flipped = do_substraction(digits_, lhs.digits_, rhs.digits_);
+        sign_ = flipped ? -sign : sign;
+        canonicalize();
+    }
 
     assert(is_canonicalized());
 }
 
-void BigNum::multiply(BigNum const& rhs) {
-    assert(is_canonicalized());
+void BigNum::multiply(BigNum const& lhs, BigNum const& rhs) {
+    assert(lhs.is_canonicalized());
     assert(rhs.is_canonicalized());
 
-    if (is_zero() || rhs.is_zero()) {
+    if (lhs.is_zero() || rhs.is_zero()) {
         *this = BigNum();
         return;
     }
 
-    digits_ = do_multiplication(digits_, rhs.digits_);
-    sign_ *= rhs.sign_;
+    auto const sign = lhs.sign_ * rhs.sign_;
+    do_multiplication(digits_, lhs.digits_, rhs.digits_);
+    sign_ = sign;
 
-    canonicalize();
+    assert(is_canonicalized());
 }
 
 void BigNum::divide(BigNum const& rhs) {
@@ -391,12 +630,6 @@ bool BigNum::is_canonicalized() const {
         return false;
     }
 
-    auto const has_overflow = std::any_of(digits_.begin(), digits_.end(),
-                                          [](auto v) { return v >= BASE; });
-    if (has_overflow) {
-        return false;
-    }
-
     return true;
 }
 
@@ -415,6 +648,21 @@ bool BigNum::is_negative() const {
     return sign_ <= 0;
 }
 
+std::size_t BigNum::limb_count() const {
+    assert(is_canonicalized());
+    return digits_.size();
+}
+
+std::size_t BigNum::bit_length() const {
+    assert(is_canonicalized());
+    return ::abacus::bignum::bit_length(digits_);
+}
+
+std::size_t BigNum::digit_count() const {
+    assert(is_canonicalized());
+    return is_zero() ? 1 : decimal_length(digits_);
+}
+
 std::pair<BigNum, BigNum> div_mod(BigNum const& lhs, BigNum const& rhs) {
     assert(lhs.is_canonicalized());
     assert(rhs.is_canonicalized());
@@ -449,6 +697,8 @@ BigNum pow(BigNum const& lhs, BigNum const& rhs) {
         return BigNum();
     }
 
+    stats::Scope counted(stats::Kernel::Pow, lhs.digits_.size());
+
     auto res = BigNum(0);
     res.digits_ = do_pow(lhs.digits_, rhs.digits_);
 
@@ -468,6 +718,8 @@ BigNum sqrt(BigNum const& num) {
             "attempt to take the square root of a negative number");
     }
 
+    stats::Scope counted(stats::Kernel::Sqrt, num.digits_.size());
+
     auto res = BigNum(0);
 
     res.digits_ = do_sqrt(num.digits_);
@@ -488,14 +740,7 @@ BigNum log2(BigNum const& num) {
             "attempt to take the log2 of a negative number");
     }
 
-    auto tmp = num;
-    auto res = BigNum(0);
-    auto one = BigNum(1);
-
-    while (tmp > one) {
-        tmp.digits_ = do_halve(tmp.digits_);
-        res += one;
-    }
+    auto res = BigNum(num.bit_length() - 1);
 
     assert(res.is_canonicalized());
 
@@ -504,7 +749,6 @@ BigNum log2(BigNum const& num) {
 
 BigNum log10(BigNum const& num) {
     assert(num.is_canonicalized());
-    assert(BASE == 10);
 
     if (num.is_zero()) {
         throw std::invalid_argument("attempt to take the log10 of zero");
@@ -513,11 +757,24 @@ BigNum log10(BigNum const& num) {
             "attempt to take the log10 of a negative number");
     }
 
-    auto res = BigNum(num.digits_.size() - 1);
+    auto res = BigNum(num.digit_count() - 1);
 
     assert(res.is_canonicalized());
 
     return res;
 }
 
+std::size_t hash_value(BigNum const& num) {
+    assert(num.is_canonicalized());
+
+    // Mix in each limb, as done by `boost::hash_combine`
+    auto res = std::hash<int>{}(num.sign_);
+    for (auto digit : num.digits_) {
+        res ^= std::hash<digit_type>{}(digit) + 0x9e3779b97f4a7c15u + (res << 6)
+               + (res >> 2);
+    }
+
+    return res;
+}
+
 } // namespace abacus::bignum
@@ -1,16 +1,30 @@
 #pragma once
 
+#include <functional>
 #include <iosfwd>
-#include <vector>
+#include <string_view>
+#include <utility>
 
+#include <cstddef>
 #include <cstdint>
 
+#include "small-vector.hh"
+
 namespace abacus::bignum {
 
+namespace expression {
+class Accumulator;
+} // namespace expression
+
+class Modulus;
+
 class BigNum {
 public:
     explicit BigNum(std::int64_t number = 0);
 
+    // Parse an optionally negative decimal number, directly from its digits
+    explicit BigNum(std::string_view decimal);
+
     friend std::ostream& operator<<(std::ostream& out, BigNum const& num) {
         return num.dump(out);
     }
@@ -29,39 +43,92 @@ public:
         return ret;
     }
 
+    friend BigNum operator-(BigNum&& rhs) {
+        rhs.flip_sign();
+        return std::move(rhs);
+    }
+
+    // Binary operators write their result in a fresh value, or re-use the
+    // storage of an expiring operand, to avoid copies and allocations
+
     friend BigNum& operator+=(BigNum& lhs, BigNum const& rhs) {
-        lhs.add(rhs);
+        lhs.add(lhs, rhs);
         return lhs;
     }
 
     friend BigNum operator+(BigNum const& lhs, BigNum const& rhs) {
-        auto ret = lhs;
-        ret += rhs;
+        BigNum ret;
+        ret.add(lhs, rhs);
         return ret;
     }
 
+    friend BigNum operator+(BigNum&& lhs, BigNum const& rhs) {
+        lhs += rhs;
+        return std::move(lhs);
+    }
+
+    friend BigNum operator+(BigNum const& lhs, BigNum&& rhs) {
+        rhs.add(lhs, rhs);
+        return std::move(rhs);
+    }
+
+    friend BigNum operator+(BigNum&& lhs, BigNum&& rhs) {
+        lhs += rhs;
+        return std::move(lhs);
+    }
+
     friend BigNum& operator-=(BigNum& lhs, BigNum const& rhs) {
-        lhs.substract(rhs);
+        lhs.substract(lhs, rhs);
         return lhs;
     }
 
     friend BigNum operator-(BigNum const& lhs, BigNum const& rhs) {
-        auto ret = lhs;
-        ret -= rhs;
+        BigNum ret;
+        ret.substract(lhs, rhs);
         return ret;
     }
 
+    friend BigNum operator-(BigNum&& lhs, BigNum const& rhs) {
+        lhs -= rhs;
+        return std::move(lhs);
+    }
+
+    friend BigNum operator-(BigNum const& lhs, BigNum&& rhs) {
+        rhs.substract(lhs, rhs);
+        return std::move(rhs);
+    }
+
+    friend BigNum operator-(BigNum&& lhs, BigNum&& rhs) {
+        lhs -= rhs;
+        return std::move(lhs);
+    }
+
     friend BigNum& operator*=(BigNum& lhs, BigNum const& rhs) {
-        lhs.multiply(rhs);
+        lhs.multiply(lhs, rhs);
         return lhs;
     }
 
     friend BigNum operator*(BigNum const& lhs, BigNum const& rhs) {
-        auto ret = lhs;
-        ret *= rhs;
+        BigNum ret;
+        ret.multiply(lhs, rhs);
         return ret;
     }
 
+    friend BigNum operator*(BigNum&& lhs, BigNum const& rhs) {
+        lhs *= rhs;
+        return std::move(lhs);
+    }
+
+    friend BigNum operator*(BigNum const& lhs, BigNum&& rhs) {
+        rhs.multiply(lhs, rhs);
+        return std::move(rhs);
+    }
+
+    friend BigNum operator*(BigNum&& lhs, BigNum&& rhs) {
+        lhs *= rhs;
+        return std::move(lhs);
+    }
+
     friend BigNum& operator/=(BigNum& lhs, BigNum const& rhs) {
         lhs.divide(rhs);
         return lhs;
@@ -73,6 +140,11 @@ public:
         return ret;
     }
 
+    friend BigNum operator/(BigNum&& lhs, BigNum const& rhs) {
+        lhs /= rhs;
+        return std::move(lhs);
+    }
+
     friend BigNum& operator%=(BigNum& lhs, BigNum const& rhs) {
         lhs.modulo(rhs);
         return lhs;
@@ -84,17 +156,29 @@ public:
         return ret;
     }
 
+    friend BigNum operator%(BigNum&& lhs, BigNum const& rhs) {
+        lhs %= rhs;
+        return std::move(lhs);
+    }
+
     friend std::pair<BigNum, BigNum> div_mod(BigNum const& lhs,
                                              BigNum const& rhs);
 
     friend BigNum pow(BigNum const& lhs, BigNum const& rhs);
 
+    // `pow(base, exponent) % modulus`, without ever computing the full power,
+    // see `modular.hh` to reuse the precomputations for a given modulus
+    friend BigNum pow_mod(BigNum const& base, BigNum const& exponent,
+                          BigNum const& modulus);
+
     friend BigNum sqrt(BigNum const& num);
 
     friend BigNum log2(BigNum const& num);
 
     friend BigNum log10(BigNum const& num);
 
+    friend std::size_t hash_value(BigNum const& num);
+
     friend bool operator==(BigNum const& lhs, BigNum const& rhs) {
         return lhs.equal(rhs);
     }
@@ -127,14 +211,32 @@ public:
     bool is_positive() const;
     bool is_negative() const;
 
+    // Number of 64-bit limbs of the magnitude, a measure of the cost of
+    // operating on it
+    std::size_t limb_count() const;
+
+    // Number of bits of the magnitude, zero having none
+    std::size_t bit_length() const;
+
+    // Number of decimal digits of the magnitude, as it would be printed. This
+    // is computed from the top limbs, in constant time for all numbers but
+    // those very close to a power of ten
+    std::size_t digit_count() const;
+
 private:
+    // Evaluates fused expressions directly on the limbs, see `expression.hh`
+    friend class expression::Accumulator;
+    // Works on the limbs of reduced values, see `modular.hh`
+    friend class Modulus;
+
     std::ostream& dump(std::ostream& out) const;
     std::istream& read(std::istream& in);
 
     void flip_sign();
-    void add(BigNum const& rhs);
-    void substract(BigNum const& rhs);
-    void multiply(BigNum const& rhs);
+    // `*this = lhs op rhs`, where `*this` may alias either operand
+    void add(BigNum const& lhs, BigNum const& rhs);
+    void substract(BigNum const& lhs, BigNum const& rhs);
+    void multiply(BigNum const& lhs, BigNum const& rhs);
     void divide(BigNum const& rhs);
     void modulo(BigNum const& rhs);
 
@@ -144,8 +246,16 @@ private:
     void canonicalize();
     bool is_canonicalized() const;
 
-    std::vector<std::uint8_t> digits_{};
+    // Little-endian base 2^64 limbs, values up to 256 bits being kept inline
+    SmallVector<std::uint64_t, 4> digits_{};
     int sign_ = 0;
 };
 
 } // namespace abacus::bignum
+
+template <>
+struct std::hash<abacus::bignum::BigNum> {
+    std::size_t operator()(abacus::bignum::BigNum const& num) const {
+        return hash_value(num);
+    }
+};
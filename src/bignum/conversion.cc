@@ -0,0 +1,233 @@
+#include "kernels.hh"
+#include "stats.hh"
+#include "tuning.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <deque>
+#include <mutex>
+
+#include <cassert>
+#include <cstring>
+
+namespace abacus::bignum::kernels {
+
+namespace {
+
+// Largest power of ten which fits in a single digit
+auto static constexpr DECIMAL_BASE = digit_type(10'000'000'000'000'000'000u);
+auto static constexpr DECIMAL_DIGITS = std::size_t(19);
+
+void trim_leading_zeros(digits_type& num) {
+    num.resize(significant_size(num));
+}
+
+// Decimal digits needed to write any number below `10^(19 * 2^rank)`
+std::size_t chunk_digits(std::size_t rank) {
+    return DECIMAL_DIGITS << rank;
+}
+
+// `10^(19 * 2^rank)`, computed by repeated squaring and memoized across calls.
+// References stay valid since a `deque` never moves its elements when growing
+digits_type const& power_of_ten(std::size_t rank) {
+    static std::mutex mutex;
+    static std::deque<digits_type> powers;
+
+    std::unique_lock lock(mutex);
+
+    if (powers.empty()) {
+        powers.emplace_back(1, DECIMAL_BASE);
+    }
+
+    // Square outside of the lock, as the product may fork tasks which end up
+    // here too, pushing to the deque keeps `last` valid
+    while (powers.size() <= rank) {
+        auto const size = powers.size();
+        auto const& last = powers.back();
+        lock.unlock();
+
+        digits_type square(2 * last.size());
+        multiply(square, last, last);
+        trim_leading_zeros(square);
+
+        lock.lock();
+        // Another thread may have computed it in the meantime
+        if (powers.size() == size) {
+            powers.push_back(std::move(square));
+        }
+    }
+
+    return powers[rank];
+}
+
+// Parse 8 decimal digits at once from their little-endian bytes, combining
+// adjacent digits into pairs, then pairs into quadruplets, then into a whole
+digit_type parse_eight_digits(char const* decimal) {
+    std::uint64_t chunk;
+    std::memcpy(&chunk, decimal, sizeof(chunk));
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00ff00ff00ff00ff;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000ffff0000ffff;
+    chunk = (chunk * 10000 + (chunk >> 32)) & 0xffffffff;
+    return chunk;
+}
+
+digit_type parse_chunk(std::string_view decimal) {
+    assert(decimal.size() <= DECIMAL_DIGITS);
+
+    digit_type res = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+        for (; decimal.size() >= 8; decimal.remove_prefix(8)) {
+            res = res * 100'000'000 + parse_eight_digits(decimal.data());
+        }
+    }
+    for (auto c : decimal) {
+        res = res * 10 + (c - '0');
+    }
+    return res;
+}
+
+// Accumulate chunks of decimal digits, most significant first
+digits_type from_decimal_basecase(std::string_view decimal) {
+    digits_type res;
+    res.reserve(decimal.size() / DECIMAL_DIGITS + 1);
+
+    auto const first_chunk = decimal.size() % DECIMAL_DIGITS;
+    for (std::size_t i = 0; i < decimal.size();) {
+        auto const len
+            = (i == 0 && first_chunk != 0) ? first_chunk : DECIMAL_DIGITS;
+
+        digit_type multiplier = 1;
+        for (std::size_t j = 0; j < len; ++j) {
+            multiplier *= 10;
+        }
+
+        auto carry = multiply_digit(res, res, multiplier);
+        carry += add_digit(res, parse_chunk(decimal.substr(i, len)));
+        if (carry != 0) {
+            res.push_back(carry);
+        }
+
+        i += len;
+    }
+
+    return res;
+}
+
+// Write exactly `chunk_digits(rank)` digits, left-padded with zeros, by
+// peeling off chunks of decimal digits, least significant first
+void to_decimal_basecase(const_digits_span num, std::size_t rank, char* out) {
+    digits_type tmp(num.begin(), num.end());
+    trim_leading_zeros(tmp);
+
+    auto const chunks = std::size_t(1) << rank;
+    for (std::size_t i = chunks; i-- > 0;) {
+        auto chunk = tmp.size() == 0 ? 0 : divide_digit(tmp, tmp, DECIMAL_BASE);
+        trim_leading_zeros(tmp);
+
+        auto const begin = out + i * DECIMAL_DIGITS;
+        for (auto it = begin + DECIMAL_DIGITS; it != begin;) {
+            *--it = '0' + chunk % 10;
+            chunk /= 10;
+        }
+    }
+
+    assert(tmp.size() == 0);
+}
+
+// Write exactly `chunk_digits(rank)` digits, left-padded with zeros, by
+// splitting around the power of ten in the middle
+void to_decimal_recursive(const_digits_span num, std::size_t rank,
+                          char* out) {
+    num = num.first(significant_size(num));
+
+    if (rank == 0 || num.size() < thresholds().radix_conversion) {
+        to_decimal_basecase(num, rank, out);
+        return;
+    }
+
+    auto const& power = power_of_ten(rank - 1);
+    auto const half = chunk_digits(rank - 1);
+
+    if (num.size() < power.size()) {
+        std::fill(out, out + half, '0');
+        to_decimal_recursive(num, rank - 1, out + half);
+        return;
+    }
+
+    digits_type quotient(num.size() - power.size() + 1);
+    digits_type remainder(power.size());
+    div_mod(quotient, remainder, num, power);
+
+    to_decimal_recursive(quotient, rank - 1, out);
+    to_decimal_recursive(remainder, rank - 1, out + half);
+}
+
+} // namespace
+
+digits_type from_decimal(std::string_view decimal) {
+    auto const leading = decimal.find_first_not_of('0');
+    decimal.remove_prefix(std::min(leading, decimal.size()));
+
+    auto const limbs = (decimal.size() + DECIMAL_DIGITS - 1) / DECIMAL_DIGITS;
+    stats::Scope counted(stats::Kernel::Read, limbs);
+
+    if (limbs <= std::max<std::size_t>(thresholds().radix_conversion, 1)) {
+        return from_decimal_basecase(decimal);
+    }
+
+    // Split off the largest tabulated power of ten, strictly shorter
+    std::size_t rank = 0;
+    while (chunk_digits(rank + 1) < decimal.size()) {
+        ++rank;
+    }
+
+    // Both halves are independent, and can be converted concurrently
+    ParallelScope scope(limbs);
+    auto const split = decimal.size() - chunk_digits(rank);
+    digits_type high, low;
+    fork_join(std::array<std::function<void()>, 2>{
+        [&] { high = from_decimal(decimal.substr(0, split)); },
+        [&] { low = from_decimal(decimal.substr(split)); },
+    });
+    auto const& power = power_of_ten(rank);
+
+    digits_type res(high.size() + power.size() + 1, 0);
+    auto const product = digits_span(res).first(high.size() + power.size());
+    multiply(product, high, power);
+    [[maybe_unused]] auto const carry = add(res, res, low);
+    assert(carry == 0);
+
+    trim_leading_zeros(res);
+
+    return res;
+}
+
+std::string to_decimal(const_digits_span num) {
+    num = num.first(significant_size(num));
+
+    if (num.size() == 0) {
+        return "0";
+    }
+
+    stats::Scope counted(stats::Kernel::Dump, num.size());
+
+    // Bound the number of digits from the bit length, rather than computing
+    // the power of ten above the number, which the conversion does not use
+    auto const bits = num.size() * DIGIT_BITS - std::countl_zero(num.back());
+    auto const digits = std::size_t(double(bits) * 0.30103) + 1;
+    std::size_t rank = 0;
+    while (chunk_digits(rank) < digits) {
+        ++rank;
+    }
+
+    std::string res(chunk_digits(rank), '0');
+    to_decimal_recursive(num, rank, res.data());
+
+    res.erase(0, res.find_first_not_of('0'));
+
+    return res;
+}
+
+} // namespace abacus::bignum::kernels
@@ -0,0 +1,168 @@
+#include "kernels.hh"
+#include "stats.hh"
+#include "tuning.hh"
+
+#include <algorithm>
+#include <bit>
+
+#include <cassert>
+
+namespace abacus::bignum::kernels {
+
+namespace {
+
+// Below these sizes, the recursion cannot make progress
+auto static constexpr QUOTIENT_MINIMUM = std::size_t(2);
+auto static constexpr DIVISOR_MINIMUM = std::size_t(4);
+
+// Compute a quotient much shorter than the divisor from the top limbs of both
+// operands, which gives at most two too many, then correct it
+void divide_approximate(digits_span quotient, digits_span num,
+                        const_digits_span divisor) {
+    auto const size = divisor.size();
+    assert(2 * quotient.size() <= size);
+
+    // Ignoring the `ignored` low limbs leaves a normalized divisor one limb
+    // longer than the quotient
+    auto const ignored = size - quotient.size() - 1;
+    auto const top_divisor = divisor.subspan(ignored);
+
+    digits_type top(num.begin() + ignored, num.end());
+    if (compare(digits_span(top).last(top_divisor.size()), top_divisor) < 0) {
+        divide(quotient, top, top_divisor);
+    } else {
+        // The true quotient is below `B^n`, saturate the estimate
+        std::fill(quotient.begin(), quotient.end(), ~digit_type(0));
+    }
+
+    digits_type product(num.size());
+    multiply(product, divisor, quotient);
+    while (compare(product, num) > 0) {
+        substract(product, product, divisor);
+        substract_digit(quotient, 1);
+    }
+
+    [[maybe_unused]] auto const borrow = substract(num, num, product);
+    assert(borrow == 0);
+}
+
+} // namespace
+
+void divide_basecase(digits_span quotient, digits_span num,
+                     const_digits_span divisor) {
+    auto const size = divisor.size();
+    assert(size >= 2);
+    assert(num.size() == quotient.size() + size);
+    assert((divisor.back() >> (DIGIT_BITS - 1)) == 1);
+    assert(compare(num.last(size), divisor) < 0);
+
+    auto const high = divisor[size - 1];
+    auto const low = divisor[size - 2];
+
+    for (auto i = quotient.size(); i-- > 0;) {
+        auto const window = num.subspan(i, size + 1);
+
+        // Estimate the quotient digit from the top limbs, it is at most two
+        // too large thanks to the normalization
+        auto const top = (double_digit_type(window[size]) << DIGIT_BITS)
+                         | window[size - 1];
+        auto estimate = top / high;
+        auto remainder = top % high;
+        while ((estimate >> DIGIT_BITS) != 0
+               || estimate * low
+                      > ((remainder << DIGIT_BITS) | window[size - 2])) {
+            --estimate;
+            remainder += high;
+            if ((remainder >> DIGIT_BITS) != 0) {
+                break;
+            }
+        }
+
+        auto const borrow = substract_multiply_digit(window.first(size),
+                                                     divisor, estimate);
+        auto const was = window[size];
+        window[size] -= borrow;
+
+        // Rarely, the estimate was still one too large: add back
+        if (was < borrow) {
+            --estimate;
+            window[size]
+                += add(window.first(size), window.first(size), divisor);
+        }
+
+        assert(window[size] == 0);
+        quotient[i] = estimate;
+    }
+}
+
+void divide_recursive(digits_span quotient, digits_span num,
+                      const_digits_span divisor) {
+    auto const size = divisor.size();
+    assert(num.size() == quotient.size() + size);
+    assert(compare(num.last(size), divisor) < 0);
+
+    if (2 * quotient.size() <= size) {
+        divide_approximate(quotient, num, divisor);
+        return;
+    }
+
+    // Compute the high half of the quotient first, which leaves the partial
+    // remainder below the divisor as required for the low half
+    auto const low = quotient.size() / 2;
+    divide(quotient.subspan(low), num.subspan(low), divisor);
+    divide(quotient.first(low), num.first(low + size), divisor);
+}
+
+void divide(digits_span quotient, digits_span num, const_digits_span divisor) {
+    auto const threshold
+        = std::max(thresholds().recursive_division, QUOTIENT_MINIMUM);
+
+    // The recursion only pays off through the approximation of quotients
+    // shorter than the divisor, which is split from longer ones
+    if (quotient.size() < threshold
+        || divisor.size() < std::max(threshold, DIVISOR_MINIMUM)) {
+        divide_basecase(quotient, num, divisor);
+    } else {
+        divide_recursive(quotient, num, divisor);
+    }
+}
+
+void div_mod(digits_span quotient, digits_span remainder, const_digits_span num,
+             const_digits_span divisor) {
+    assert(num.size() >= divisor.size());
+    assert(quotient.size() == num.size() - divisor.size() + 1);
+    assert(remainder.size() == divisor.size());
+    assert(divisor.size() != 0 && divisor.back() != 0);
+
+    stats::Scope counted(stats::Kernel::DivMod, num.size());
+
+    if (divisor.size() == 1) {
+        remainder[0] = divide_digit(quotient, num, divisor[0]);
+        return;
+    }
+
+    // Normalize the divisor so that its top bit is set, shifting the dividend
+    // by the same amount into an extra limb, which becomes the remainder
+    auto const shift = std::countl_zero(divisor.back());
+
+    digits_type normalized(divisor.begin(), divisor.end());
+    digits_type partial(num.size() + 1);
+    if (shift != 0) {
+        shift_left(normalized, divisor, shift);
+        partial.back()
+            = shift_left(digits_span(partial).first(num.size()), num, shift);
+    } else {
+        std::copy(num.begin(), num.end(), partial.begin());
+    }
+
+    divide(quotient, partial, normalized);
+
+    auto const low = digits_span(partial).first(divisor.size());
+    if (shift != 0) {
+        shift_right(remainder, low, shift);
+    } else {
+        std::copy(low.begin(), low.end(), remainder.begin());
+    }
+}
+
+} // namespace abacus::bignum::kernels
@@ -0,0 +1,116 @@
+#include "expression.hh"
+
+#include <algorithm>
+
+#include <cassert>
+
+#include "kernels.hh"
+#include "tuning.hh"
+
+namespace abacus::bignum::expression {
+
+using kernels::const_digits_span;
+using kernels::digit_type;
+using kernels::digits_span;
+using kernels::DIGIT_BITS;
+
+namespace {
+
+bool is_sign_bit_set(const_digits_span num) {
+    return num.size() != 0 && (num.back() >> (DIGIT_BITS - 1)) != 0;
+}
+
+// Add `num` to, or substract it from, `acc`, wrapping around on overflow
+void accumulate(digits_span acc, const_digits_span num, bool negative) {
+    assert(acc.size() >= num.size());
+
+    if (negative) {
+        kernels::substract(acc, acc, num);
+    } else {
+        kernels::add(acc, acc, num);
+    }
+}
+
+} // namespace
+
+void Accumulator::reserve(BigNum const& num) {
+    width_ = std::max(width_, num.digits_.size() + 1);
+}
+
+void Accumulator::reserve(BigNum const& lhs, BigNum const& rhs) {
+    width_ = std::max(width_, lhs.digits_.size() + rhs.digits_.size() + 1);
+}
+
+void Accumulator::add(BigNum const& num, bool negated) {
+    if (num.is_zero()) {
+        return;
+    }
+
+    extend(num.digits_.size() + 1);
+    accumulate(digits_, num.digits_, (num.sign_ < 0) != negated);
+}
+
+void Accumulator::add(BigNum const& lhs, BigNum const& rhs, bool negated) {
+    if (lhs.is_zero() || rhs.is_zero()) {
+        return;
+    }
+
+    auto const& longest = lhs.digits_.size() < rhs.digits_.size() ? rhs : lhs;
+    auto const& shortest = lhs.digits_.size() < rhs.digits_.size() ? lhs : rhs;
+    auto const size = longest.digits_.size();
+    auto const negative = (lhs.sign_ * rhs.sign_ < 0) != negated;
+
+    extend(lhs.digits_.size() + rhs.digits_.size() + 1);
+
+    if (shortest.digits_.size() >= std::max<std::size_t>(
+            thresholds().karatsuba, 2)) {
+        kernels::digits_type product(lhs.digits_.size() + rhs.digits_.size());
+        kernels::multiply(product, lhs.digits_, rhs.digits_);
+        accumulate(digits_, product, negative);
+        return;
+    }
+
+    // Fuse the schoolbook product into the sum, one row at a time
+    for (std::size_t i = 0; i < shortest.digits_.size(); ++i) {
+        auto const row = digits_span(digits_).subspan(i);
+        auto const digit = shortest.digits_[i];
+        if (negative) {
+            auto const borrow = kernels::substract_multiply_digit(
+                row.first(size), longest.digits_, digit);
+            kernels::substract_digit(row.subspan(size), borrow);
+        } else {
+            auto const carry = kernels::add_multiply_digit(
+                row.first(size), longest.digits_, digit);
+            kernels::add_digit(row.subspan(size), carry);
+        }
+    }
+}
+
+BigNum Accumulator::result() && {
+    auto const negative = is_sign_bit_set(digits_);
+    if (negative) {
+        for (auto& digit : digits_) {
+            digit = ~digit;
+        }
+        kernels::add_digit(digits_, 1);
+    }
+
+    BigNum res;
+    res.digits_ = std::move(digits_);
+    res.sign_ = negative ? -1 : 1;
+    res.canonicalize();
+
+    return res;
+}
+
+void Accumulator::extend(std::size_t size) {
+    width_ = std::max(width_, size);
+    if (digits_.size() >= width_) {
+        return;
+    }
+
+    auto const fill = is_sign_bit_set(digits_) ? ~digit_type(0) : 0;
+    digits_.resize(width_, fill);
+}
+
+} // namespace abacus::bignum::expression
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <concepts>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bignum.hh"
+#include "small-vector.hh"
+
+// Opt-in lazy arithmetic: wrapping an operand in `lazy` makes the operators
+// build an expression instead of computing intermediate values. Sums of
+// operands and of two-operand products, such as `lazy(a) * b + c - d`, are then
+// evaluated in a single pass into one result buffer when converted to `BigNum`.
+//
+// Expressions only hold references to their operands, they should be evaluated
+// within the full-expression which created them, like `BigNum r = ...;`.
+namespace abacus::bignum::expression {
+
+// Running sum of terms, which `Sum` feeds in two passes: first reserving room
+// for all of them, then adding them up
+class Accumulator {
+public:
+    void reserve(BigNum const& num);
+    void reserve(BigNum const& lhs, BigNum const& rhs);
+
+    void add(BigNum const& num, bool negated);
+    void add(BigNum const& lhs, BigNum const& rhs, bool negated);
+
+    BigNum result() &&;
+
+private:
+    void extend(std::size_t size);
+
+    // Two's complement, with at least one limb to spare for the sign
+    SmallVector<std::uint64_t, 4> digits_{};
+    std::size_t width_ = 1;
+};
+
+class Term {
+public:
+    explicit Term(BigNum const& num, bool negated = false)
+        : num_(num), negated_(negated) {}
+
+    Term operator-() const {
+        return Term(num_, !negated_);
+    }
+
+    void reserve(Accumulator& acc) const {
+        acc.reserve(num_);
+    }
+
+    void accumulate(Accumulator& acc) const {
+        acc.add(num_, negated_);
+    }
+
+    operator BigNum() const;
+
+    BigNum const& operand() const {
+        return num_;
+    }
+
+    bool negated() const {
+        return negated_;
+    }
+
+private:
+    BigNum const& num_;
+    bool negated_;
+};
+
+class Product {
+public:
+    Product(BigNum const& lhs, BigNum const& rhs, bool negated = false)
+        : lhs_(lhs), rhs_(rhs), negated_(negated) {}
+
+    Product operator-() const {
+        return Product(lhs_, rhs_, !negated_);
+    }
+
+    void reserve(Accumulator& acc) const {
+        acc.reserve(lhs_, rhs_);
+    }
+
+    void accumulate(Accumulator& acc) const {
+        acc.add(lhs_, rhs_, negated_);
+    }
+
+    operator BigNum() const;
+
+private:
+    BigNum const& lhs_;
+    BigNum const& rhs_;
+    bool negated_;
+};
+
+template <typename... Terms>
+class Sum {
+public:
+    explicit Sum(std::tuple<Terms...> terms) : terms_(std::move(terms)) {}
+
+    Sum operator-() const {
+        return Sum(std::apply(
+            [](auto const&... terms) { return std::make_tuple(-terms...); },
+            terms_));
+    }
+
+    std::tuple<Terms...> const& terms() const {
+        return terms_;
+    }
+
+    BigNum evaluate() const {
+        Accumulator acc;
+        std::apply([&](auto const&... terms) { (terms.reserve(acc), ...); },
+                   terms_);
+        std::apply([&](auto const&... terms) { (terms.accumulate(acc), ...); },
+                   terms_);
+        return std::move(acc).result();
+    }
+
+    operator BigNum() const {
+        return evaluate();
+    }
+
+private:
+    std::tuple<Terms...> terms_;
+};
+
+inline Term lazy(BigNum const& num) {
+    return Term(num);
+}
+
+template <typename T>
+struct is_sum : std::false_type {};
+
+template <typename... Terms>
+struct is_sum<Sum<Terms...>> : std::true_type {};
+
+template <typename T>
+concept Expression = std::same_as<T, Term> || std::same_as<T, Product>
+                     || is_sum<T>::value;
+
+template <typename T>
+concept Operand = Expression<T> || std::same_as<T, BigNum>;
+
+// View any operand as a sum of terms
+template <Operand T>
+auto as_sum(T const& operand) {
+    if constexpr (std::same_as<T, BigNum>) {
+        return Sum<Term>(std::make_tuple(Term(operand)));
+    } else if constexpr (is_sum<T>::value) {
+        return operand;
+    } else {
+        return Sum<T>(std::make_tuple(operand));
+    }
+}
+
+// View a factor of a product as a term
+template <Operand T>
+Term as_term(T const& operand) {
+    if constexpr (std::same_as<T, BigNum>) {
+        return Term(operand);
+    } else {
+        static_assert(std::same_as<T, Term>,
+                      "only products of two operands can be fused");
+        return operand;
+    }
+}
+
+// Take over any binary operation involving an expression. Forwarding references
+// make the overloads exact matches for expiring `BigNum` operands, which would
+// otherwise be ambiguous with its own rvalue overloads
+template <typename Lhs, typename Rhs>
+concept Binary = Operand<std::remove_cvref_t<Lhs>>
+                 && Operand<std::remove_cvref_t<Rhs>>
+                 && (Expression<std::remove_cvref_t<Lhs>>
+                     || Expression<std::remove_cvref_t<Rhs>>);
+
+template <typename... Lhs, typename... Rhs>
+Sum<Lhs..., Rhs...> concatenate(Sum<Lhs...> const& lhs,
+                                Sum<Rhs...> const& rhs) {
+    return Sum<Lhs..., Rhs...>(std::tuple_cat(lhs.terms(), rhs.terms()));
+}
+
+template <typename Lhs, typename Rhs>
+    requires Binary<Lhs, Rhs>
+auto operator+(Lhs&& lhs, Rhs&& rhs) {
+    return concatenate(as_sum(lhs), as_sum(rhs));
+}
+
+template <typename Lhs, typename Rhs>
+    requires Binary<Lhs, Rhs>
+auto operator-(Lhs&& lhs, Rhs&& rhs) {
+    return concatenate(as_sum(lhs), -as_sum(rhs));
+}
+
+template <typename Lhs, typename Rhs>
+    requires Binary<Lhs, Rhs>
+Product operator*(Lhs&& lhs, Rhs&& rhs) {
+    auto const lhs_term = as_term(lhs);
+    auto const rhs_term = as_term(rhs);
+    return Product(lhs_term.operand(), rhs_term.operand(),
+                   lhs_term.negated() != rhs_term.negated());
+}
+
+template <Expression T>
+BigNum evaluate(T const& expression) {
+    return as_sum(expression).evaluate();
+}
+
+inline Term::operator BigNum() const {
+    return evaluate(*this);
+}
+
+inline Product::operator BigNum() const {
+    return evaluate(*this);
+}
+
+} // namespace abacus::bignum::expression
@@ -0,0 +1,169 @@
+#include "kernels.hh"
+
+#include <algorithm>
+
+#include <cassert>
+
+namespace abacus::bignum::kernels {
+
+std::size_t significant_size(const_digits_span num) {
+    auto size = num.size();
+    while (size > 0 && num[size - 1] == 0) {
+        --size;
+    }
+    return size;
+}
+
+int compare(const_digits_span lhs, const_digits_span rhs) {
+    if (lhs.size() != rhs.size()) {
+        return lhs.size() < rhs.size() ? -1 : 1;
+    }
+
+    for (auto i = lhs.size(); i-- > 0;) {
+        if (lhs[i] != rhs[i]) {
+            return lhs[i] < rhs[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+digit_type add_digit(digits_span num, digit_type carry) {
+    for (std::size_t i = 0; carry != 0 && i < num.size(); ++i) {
+        num[i] += carry;
+        carry = num[i] < carry;
+    }
+    return carry;
+}
+
+digit_type substract_digit(digits_span num, digit_type borrow) {
+    for (std::size_t i = 0; borrow != 0 && i < num.size(); ++i) {
+        auto const was = num[i];
+        num[i] -= borrow;
+        borrow = was < borrow;
+    }
+    return borrow;
+}
+
+digit_type add(digits_span res, const_digits_span lhs, const_digits_span rhs) {
+    assert(res.size() == lhs.size());
+    assert(lhs.size() >= rhs.size());
+
+    double_digit_type carry = 0;
+    for (std::size_t i = 0; i < rhs.size(); ++i) {
+        auto const addition = double_digit_type(lhs[i]) + rhs[i] + carry;
+        res[i] = addition;
+        carry = addition >> DIGIT_BITS;
+    }
+
+    if (res.data() != lhs.data()) {
+        std::copy(lhs.begin() + rhs.size(), lhs.end(),
+                  res.begin() + rhs.size());
+    }
+
+    return add_digit(res.subspan(rhs.size()), carry);
+}
+
+digit_type substract(digits_span res, const_digits_span lhs,
+                     const_digits_span rhs) {
+    assert(res.size() == lhs.size());
+    assert(lhs.size() >= rhs.size());
+
+    digit_type borrow = 0;
+    for (std::size_t i = 0; i < rhs.size(); ++i) {
+        auto const substraction = double_digit_type(lhs[i]) - rhs[i] - borrow;
+        res[i] = substraction;
+        // Wrapping around sets the upper half
+        borrow = (substraction >> DIGIT_BITS) != 0;
+    }
+
+    if (res.data() != lhs.data()) {
+        std::copy(lhs.begin() + rhs.size(), lhs.end(),
+                  res.begin() + rhs.size());
+    }
+
+    return substract_digit(res.subspan(rhs.size()), borrow);
+}
+
+digit_type multiply_digit(digits_span res, const_digits_span lhs,
+                          digit_type rhs) {
+    assert(res.size() == lhs.size());
+
+    digit_type carry = 0;
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        auto const multiplication = double_digit_type(lhs[i]) * rhs + carry;
+        res[i] = multiplication;
+        carry = multiplication >> DIGIT_BITS;
+    }
+    return carry;
+}
+
+digit_type add_multiply_digit(digits_span res, const_digits_span lhs,
+                              digit_type rhs) {
+    assert(res.size() == lhs.size());
+
+    digit_type carry = 0;
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        auto const multiplication
+            = double_digit_type(lhs[i]) * rhs + res[i] + carry;
+        res[i] = multiplication;
+        carry = multiplication >> DIGIT_BITS;
+    }
+    return carry;
+}
+
+digit_type substract_multiply_digit(digits_span res, const_digits_span lhs,
+                                    digit_type rhs) {
+    assert(res.size() == lhs.size());
+
+    digit_type borrow = 0;
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        auto const multiplication = double_digit_type(lhs[i]) * rhs + borrow;
+        auto const low = digit_type(multiplication);
+        borrow = (multiplication >> DIGIT_BITS) + (res[i] < low);
+        res[i] -= low;
+    }
+    return borrow;
+}
+
+digit_type divide_digit(digits_span res, const_digits_span num,
+                        digit_type divisor) {
+    assert(res.size() == num.size());
+    assert(divisor != 0);
+
+    double_digit_type remainder = 0;
+    for (auto i = num.size(); i-- > 0;) {
+        auto const current = (remainder << DIGIT_BITS) | num[i];
+        res[i] = current / divisor;
+        remainder = current % divisor;
+    }
+    return remainder;
+}
+
+digit_type shift_left(digits_span res, const_digits_span num, unsigned shift) {
+    assert(res.size() == num.size());
+    assert(0 < shift && shift < DIGIT_BITS);
+
+    digit_type carry = 0;
+    for (std::size_t i = 0; i < num.size(); ++i) {
+        auto const digit = num[i];
+        res[i] = (digit << shift) | carry;
+        carry = digit >> (DIGIT_BITS - shift);
+    }
+    return carry;
+}
+
+digit_type shift_right(digits_span res, const_digits_span num, unsigned shift) {
+    assert(res.size() == num.size());
+    assert(0 < shift && shift < DIGIT_BITS);
+
+    digit_type carry = 0;
+    for (auto i = num.size(); i-- > 0;) {
+        auto const digit = num[i];
+        res[i] = (digit >> shift) | carry;
+        carry = digit << (DIGIT_BITS - shift);
+    }
+    return carry;
+}
+
+} // namespace abacus::bignum::kernels
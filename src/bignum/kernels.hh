@@ -0,0 +1,182 @@
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <cstdint>
+
+#include "small-vector.hh"
+
+// Low-level routines operating on little-endian spans of limbs, in the spirit
+// of GMP's `mpn` layer. Unless specified otherwise, the output span may alias
+// an input span only if they start at the same limb.
+namespace abacus::bignum::kernels {
+
+using digit_type = std::uint64_t;
+using double_digit_type = unsigned __int128;
+using digits_type = SmallVector<digit_type, 4>;
+
+using digits_span = std::span<digit_type>;
+using const_digits_span = std::span<digit_type const>;
+
+auto constexpr DIGIT_BITS = std::numeric_limits<digit_type>::digits;
+
+// Size of the number once its leading zeros are ignored
+std::size_t significant_size(const_digits_span num);
+
+// Compare magnitudes, returning a negative, zero, or positive value
+int compare(const_digits_span lhs, const_digits_span rhs);
+
+// `num += carry`, returning the carry out
+digit_type add_digit(digits_span num, digit_type carry);
+
+// `num -= borrow`, returning the borrow out
+digit_type substract_digit(digits_span num, digit_type borrow);
+
+// `res = lhs + rhs`, where `res.size() == lhs.size() >= rhs.size()`, returning
+// the carry out
+digit_type add(digits_span res, const_digits_span lhs, const_digits_span rhs);
+
+// `res = lhs - rhs`, where `res.size() == lhs.size() >= rhs.size()`, returning
+// the borrow out
+digit_type substract(digits_span res, const_digits_span lhs,
+                     const_digits_span rhs);
+
+// `res = lhs * rhs`, where `res.size() == lhs.size()`, returning the high limb
+digit_type multiply_digit(digits_span res, const_digits_span lhs,
+                          digit_type rhs);
+
+// `res += lhs * rhs`, where `res.size() == lhs.size()`, returning the carry out
+digit_type add_multiply_digit(digits_span res, const_digits_span lhs,
+                              digit_type rhs);
+
+// `res -= lhs * rhs`, where `res.size() == lhs.size()`, returning the borrow
+digit_type substract_multiply_digit(digits_span res, const_digits_span lhs,
+                                    digit_type rhs);
+
+// `res = num / divisor`, where `res.size() == num.size()`, returning the
+// remainder
+digit_type divide_digit(digits_span res, const_digits_span num,
+                        digit_type divisor);
+
+// `res = num << shift`, where `0 < shift < DIGIT_BITS`, returning the bits
+// shifted out
+digit_type shift_left(digits_span res, const_digits_span num, unsigned shift);
+
+// `res = num >> shift`, where `0 < shift < DIGIT_BITS`, returning the bits
+// shifted out in the high end of the result
+digit_type shift_right(digits_span res, const_digits_span num, unsigned shift);
+
+// The multiplication routines below compute `res = lhs * rhs`, where
+// `res.size() == lhs.size() + rhs.size()` and `res` does not overlap its inputs
+
+// Quadratic schoolbook multiplication
+void multiply_basecase(digits_span res, const_digits_span lhs,
+                       const_digits_span rhs);
+
+// Schoolbook multiplication in place, where the low `num.size() - rhs.size()`
+// limbs of `num` hold the multiplicand, and `rhs` does not overlap `num`
+void multiply_in_place(digits_span num, const_digits_span rhs);
+
+// One level of Karatsuba, requires `lhs.size() >= rhs.size() > lhs.size() / 2`
+void multiply_karatsuba(digits_span res, const_digits_span lhs,
+                        const_digits_span rhs);
+
+// One level of Toom-3, requires `lhs.size() >= rhs.size() > 2 * lhs.size() / 3`
+void multiply_toom3(digits_span res, const_digits_span lhs,
+                    const_digits_span rhs);
+
+// Three-prime number-theoretic transform, with exact CRT recombination
+void multiply_ntt(digits_span res, const_digits_span lhs,
+                  const_digits_span rhs);
+
+// Pick the fastest algorithm for the given operand sizes, squaring when both
+// operands are the same span
+void multiply(digits_span res, const_digits_span lhs, const_digits_span rhs);
+
+// The squaring routines below compute `res = num * num`, where `res.size() == 2
+// * num.size()` and `res` does not overlap `num`. Symmetry saves about half of
+// the limb products of the basecase, and one transform or operand evaluation of
+// the recursive algorithms
+
+// Schoolbook squaring, computing each cross product once then doubling them
+void square_basecase(digits_span res, const_digits_span num);
+
+// One level of Karatsuba, requires `num.size() >= 2`
+void square_karatsuba(digits_span res, const_digits_span num);
+
+// One level of Toom-3, requires `num.size() > 2 * ((num.size() + 2) / 3)`
+void square_toom3(digits_span res, const_digits_span num);
+
+// Three-prime number-theoretic transform, transforming the operand only once
+void square_ntt(digits_span res, const_digits_span num);
+
+// Pick the fastest algorithm for the given operand size
+void square(digits_span res, const_digits_span num);
+
+// Knuth's algorithm D, computing `quotient = num / divisor` in place: `num` is
+// left holding the remainder in its low `divisor.size()` limbs, and zeros
+// above. Requires `divisor` to be normalized, i.e: have its most significant
+// bit set, with `divisor.size() >= 2`, `num.size() == quotient.size() +
+// divisor.size()`, and the top `divisor.size()` limbs of `num` less than
+// `divisor`
+void divide_basecase(digits_span quotient, digits_span num,
+                     const_digits_span divisor);
+
+// Divide-and-conquer division in the style of Burnikel-Ziegler, with the same
+// contract as `divide_basecase`. Quotients much shorter than the divisor are
+// approximated from the top limbs, longer ones are split in halves
+void divide_recursive(digits_span quotient, digits_span num,
+                      const_digits_span divisor);
+
+// Pick the fastest algorithm for the given operand sizes, with the same
+// contract as `divide_basecase`
+void divide(digits_span quotient, digits_span num, const_digits_span divisor);
+
+// `quotient = num / divisor` and `remainder = num % divisor`, for any divisor
+// without leading zeros. Requires `num.size() >= divisor.size()`, with
+// `quotient.size() == num.size() - divisor.size() + 1` and `remainder.size()
+// == divisor.size()`
+void div_mod(digits_span quotient, digits_span remainder, const_digits_span num,
+             const_digits_span divisor);
+
+// Work on large operands can be split across threads, up to `threads()` of
+// them per operation, each part getting a share of those for its own splits
+
+// Keeps the work on `size` limbs in its scope on the calling thread if it is
+// below `Thresholds::parallel`
+class ParallelScope {
+public:
+    explicit ParallelScope(std::size_t size);
+    ~ParallelScope();
+
+    ParallelScope(ParallelScope const&) = delete;
+    ParallelScope& operator=(ParallelScope const&) = delete;
+
+private:
+    std::size_t previous_;
+};
+
+// Whether the current operation may use more than one thread
+bool can_fork();
+
+// Run all of `tasks`, concurrently if the current operation may use more than
+// one thread
+void fork_join(std::span<std::function<void()> const> tasks);
+
+// Run `body(first, last)` on ranges partitioning `[0, count)`, concurrently if
+// allowed for ranges of at least `grain` elements
+void parallel_for(std::size_t count, std::size_t grain,
+                  std::function<void(std::size_t, std::size_t)> const& body);
+
+// Parse a string made only of decimal digits, without leading zeros in the
+// result
+digits_type from_decimal(std::string_view decimal);
+
+// Print a number as decimal digits, without leading zeros
+std::string to_decimal(const_digits_span num);
+
+} // namespace abacus::bignum::kernels
@@ -0,0 +1,309 @@
+#include "modular.hh"
+
+#include <algorithm>
+#include <bit>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+
+#include "kernels.hh"
+#include "stats.hh"
+#include "tuning.hh"
+
+namespace abacus::bignum {
+
+using kernels::const_digits_span;
+using kernels::digit_type;
+using kernels::digits_span;
+using kernels::digits_type;
+using kernels::DIGIT_BITS;
+
+namespace {
+
+// Two's complement negation, modulo `2^(64 * num.size())`
+void negate(digits_span num) {
+    for (auto& digit : num) {
+        digit = ~digit;
+    }
+    kernels::add_digit(num, 1);
+}
+
+// `lhs * rhs` modulo `2^(64 * size)`
+digits_type low_product(const_digits_span lhs, const_digits_span rhs,
+                        std::size_t size) {
+    digits_type res(lhs.size() + rhs.size());
+    kernels::multiply(res, lhs, rhs);
+    res.resize(size);
+    return res;
+}
+
+// `-modulus^-1` modulo `2^(64 * modulus.size())`, lifting the inverse modulo a
+// limb with Newton's iteration `x * (2 - modulus * x)`, which doubles the
+// number of correct limbs at each step
+digits_type negated_inverse(const_digits_span modulus, digit_type inverse) {
+    digits_type res(1, inverse);
+    for (std::size_t size = 1; size < modulus.size();) {
+        size = std::min(2 * size, modulus.size());
+        auto correction = low_product(modulus.first(size), res, size);
+        negate(correction);
+        kernels::add_digit(correction, 2);
+        res = low_product(res, correction, size);
+    }
+    negate(res);
+    return res;
+}
+
+// Whether `num`, which may have leading zeros, is at least `modulus`
+bool at_least(const_digits_span num, const_digits_span modulus) {
+    return kernels::compare(num.first(kernels::significant_size(num)), modulus)
+           >= 0;
+}
+
+bool test_bit(digits_type const& num, std::size_t bit) {
+    return (num[bit / DIGIT_BITS] >> (bit % DIGIT_BITS)) & 1;
+}
+
+// Number of bits of the exponent handled by each multiplication of the sliding
+// window exponentiation, minimizing the table's size plus the expected
+// multiplications, all of them being the size of the modulus
+std::size_t window_size(std::size_t exponent_bits) {
+    std::size_t res = 1;
+    for (auto bits : {6, 24, 80, 240, 672}) {
+        if (exponent_bits > std::size_t(bits)) {
+            ++res;
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+Modulus::Modulus(BigNum const& modulus) : modulus_(modulus.digits_) {
+    if (modulus_.size() == 0) {
+        throw std::invalid_argument("attempt to divide by zero");
+    }
+
+    auto const size = modulus_.size();
+    montgomery_ = modulus_[0] % 2 == 1;
+
+    // Both reductions need `2^(128 * size)` divided by the modulus
+    digits_type power(2 * size + 1, 0);
+    power.back() = 1;
+    digits_type quotient(size + 2);
+    digits_type remainder(size);
+    kernels::div_mod(quotient, remainder, power, modulus_);
+
+    if (!montgomery_) {
+        quotient.resize(kernels::significant_size(quotient));
+        reciprocal_ = std::move(quotient);
+        return;
+    }
+
+    r_squared_ = std::move(remainder);
+
+    // Newton's iteration doubles the correct bits each step
+    digit_type inverse = modulus_[0];
+    for (int i = 0; i < 5; ++i) {
+        inverse *= 2 - modulus_[0] * inverse;
+    }
+    inverse_ = -inverse;
+
+    if (size >= thresholds().montgomery_products) {
+        full_inverse_ = negated_inverse(modulus_, inverse);
+    }
+}
+
+bool Modulus::matches(BigNum const& modulus) const {
+    return modulus_ == modulus.digits_;
+}
+
+BigNum Modulus::pow(BigNum const& base, BigNum const& exponent) const {
+    auto const size = modulus_.size();
+
+    // Same results as computing the power, then its remainder
+    if (exponent.is_zero()) {
+        return size == 1 && modulus_[0] == 1 ? BigNum() : BigNum(1);
+    } else if (exponent.is_negative() || base.is_zero()) {
+        return BigNum();
+    }
+
+    stats::Scope counted(stats::Kernel::PowMod, size);
+
+    digits_type num(size, 0);
+    if (kernels::compare(base.digits_, modulus_) < 0) {
+        std::copy(base.digits_.begin(), base.digits_.end(), num.begin());
+    } else {
+        digits_type quotient(base.digits_.size() - size + 1);
+        kernels::div_mod(quotient, num, base.digits_, modulus_);
+    }
+
+    if (kernels::significant_size(num) == 0) {
+        return BigNum();
+    }
+
+    Scratch scratch;
+    to_form(num, scratch);
+
+    auto const& bits = exponent.digits_;
+    auto const bit_count = bits.size() * DIGIT_BITS
+                           - std::countl_zero(bits.back());
+    auto const window = window_size(bit_count);
+
+    // Odd powers `num^1, num^3, ..., num^(2^window - 1)`
+    std::vector<digits_type> powers(std::size_t(1) << (window - 1));
+    powers[0] = std::move(num);
+    if (powers.size() > 1) {
+        digits_type square;
+        multiply(square, powers[0], powers[0], scratch);
+        for (std::size_t i = 1; i < powers.size(); ++i) {
+            multiply(powers[i], powers[i - 1], square, scratch);
+        }
+    }
+
+    // Consume the exponent from its top bit, each window ending in a one
+    digits_type res;
+    for (auto top = bit_count; top > 0;) {
+        if (!test_bit(bits, top - 1)) {
+            multiply(res, res, res, scratch);
+            --top;
+            continue;
+        }
+
+        auto low = top > window ? top - window : 0;
+        while (!test_bit(bits, low)) {
+            ++low;
+        }
+        std::size_t value = 0;
+        for (auto bit = top; bit-- > low;) {
+            value = 2 * value + test_bit(bits, bit);
+        }
+
+        if (res.size() == 0) {
+            res = powers[value / 2];
+        } else {
+            for (auto bit = low; bit < top; ++bit) {
+                multiply(res, res, res, scratch);
+            }
+            multiply(res, res, powers[value / 2], scratch);
+        }
+        top = low;
+    }
+
+    from_form(res, scratch);
+
+    auto const negative = base.is_negative() && test_bit(bits, 0);
+
+    BigNum result;
+    result.digits_ = std::move(res);
+    result.sign_ = negative ? -1 : 1;
+    result.canonicalize();
+
+    return result;
+}
+
+void Modulus::to_form(digits_type& num, Scratch& scratch) const {
+    if (montgomery_) {
+        multiply(num, num, r_squared_, scratch);
+    }
+}
+
+void Modulus::from_form(digits_type& num, Scratch& scratch) const {
+    if (montgomery_) {
+        auto& product = scratch.product;
+        product.assign(2 * modulus_.size() + 1, 0);
+        std::copy(num.begin(), num.end(), product.begin());
+        reduce(num, scratch);
+    }
+}
+
+void Modulus::multiply(digits_type& res, digits_type const& lhs,
+                       digits_type const& rhs, Scratch& scratch) const {
+    auto const size = modulus_.size();
+    assert(lhs.size() == size && rhs.size() == size);
+
+    // Keep a spare limb on top for the carries of the reduction
+    auto& product = scratch.product;
+    product.resize(2 * size + 1);
+    product.back() = 0;
+    kernels::multiply(digits_span(product).first(2 * size), lhs, rhs);
+
+    reduce(res, scratch);
+}
+
+void Modulus::reduce(digits_type& res, Scratch& scratch) const {
+    auto const size = modulus_.size();
+    auto const product = digits_span(scratch.product);
+    assert(product.size() == 2 * size + 1);
+
+    if (montgomery_) {
+        if (full_inverse_.size() == 0) {
+            // Cancel the low limbs one at a time, with multiples of the modulus
+            for (std::size_t i = 0; i < size; ++i) {
+                auto const factor = product[i] * inverse_;
+                auto const carry = kernels::add_multiply_digit(
+                    product.subspan(i, size), modulus_, factor);
+                kernels::add_digit(product.subspan(i + size), carry);
+            }
+        } else {
+            // Or all at once, `t + (t * -modulus^-1 % R) * modulus` being a
+            // multiple of `R`
+            auto& factor = scratch.quotient;
+            factor.resize(2 * size);
+            kernels::multiply(factor, product.first(size), full_inverse_);
+            auto& multiple = scratch.multiple;
+            multiple.resize(2 * size);
+            kernels::multiply(multiple, digits_span(factor).first(size),
+                              modulus_);
+            [[maybe_unused]] auto const carry
+                = kernels::add(product, product, multiple);
+            assert(carry == 0);
+        }
+
+        // Dividing by `R` leaves a value below twice the modulus
+        auto const high = product.subspan(size);
+        if (at_least(high, modulus_)) {
+            kernels::substract(high, high, modulus_);
+        }
+        res.assign(high.begin(), high.begin() + size);
+        return;
+    }
+
+    // Estimate the quotient from the top limbs, which is short by at most two
+    auto const top = product.subspan(size - 1, size + 1);
+    auto& estimate = scratch.quotient;
+    estimate.resize(top.size() + reciprocal_.size());
+    kernels::multiply(estimate, top, reciprocal_);
+    auto const quotient = digits_span(estimate).subspan(size + 1);
+
+    // Which makes the remainder below three times the modulus, only its low
+    // limbs are computed
+    auto const low_quotient
+        = quotient.first(std::min(quotient.size(), size + 1));
+    auto& multiple = scratch.multiple;
+    multiple.resize(low_quotient.size() + size);
+    kernels::multiply(multiple, low_quotient, modulus_);
+
+    auto const remainder = product.first(size + 1);
+    kernels::substract(
+        remainder, remainder,
+        digits_span(multiple).first(std::min(multiple.size(), size + 1)));
+    while (at_least(remainder, modulus_)) {
+        kernels::substract(remainder, remainder, modulus_);
+    }
+    res.assign(remainder.begin(), remainder.begin() + size);
+}
+
+BigNum pow_mod(BigNum const& base, BigNum const& exponent,
+               BigNum const& modulus) {
+    // Keep the context of the last modulus, as the same one is often reused
+    thread_local std::optional<Modulus> context;
+    if (!context || !context->matches(modulus)) {
+        context.emplace(modulus);
+    }
+    return context->pow(base, exponent);
+}
+
+} // namespace abacus::bignum
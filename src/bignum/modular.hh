@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "bignum.hh"
+#include "small-vector.hh"
+
+namespace abacus::bignum {
+
+// Arithmetic modulo a fixed number, reducing products with Montgomery's method
+// for odd moduli, and Barrett's otherwise. Building a context costs about as
+// much as a division by the modulus, it can then be reused for any number of
+// operations with the same modulus, concurrently.
+class Modulus {
+public:
+    // The sign of `modulus` is ignored, as for the remainder of a division
+    explicit Modulus(BigNum const& modulus);
+
+    // Whether this is the context of `modulus`, up to its sign
+    bool matches(BigNum const& modulus) const;
+
+    // `pow(base, exponent) % modulus`, reducing every intermediate value so
+    // that they all stay the size of the modulus
+    BigNum pow(BigNum const& base, BigNum const& exponent) const;
+
+private:
+    using digits_type = SmallVector<std::uint64_t, 4>;
+
+    // Buffers for products and their reduction, allocated once per operation
+    struct Scratch {
+        digits_type product{};
+        digits_type quotient{};
+        digits_type multiple{};
+    };
+
+    // Reduced values are exactly as many limbs as the modulus, in Montgomery
+    // form for odd moduli
+    void to_form(digits_type& num, Scratch& scratch) const;
+    void from_form(digits_type& num, Scratch& scratch) const;
+
+    // `res = lhs * rhs`, reduced, where `res` may alias either operand
+    void multiply(digits_type& res, digits_type const& lhs,
+                  digits_type const& rhs, Scratch& scratch) const;
+
+    // Reduce `scratch.product`, below the modulus squared, into `res`
+    void reduce(digits_type& res, Scratch& scratch) const;
+
+    digits_type modulus_{};
+    bool montgomery_ = false;
+    // `-modulus^-1` modulo a limb, and modulo `R = 2^(64 * size)` for moduli
+    // long enough to reduce with a couple of products, see `tuning.hh`
+    std::uint64_t inverse_ = 0;
+    digits_type full_inverse_{};
+    // `R^2 % modulus`, to enter Montgomery form
+    digits_type r_squared_{};
+    // `2^(128 * size) / modulus`, to estimate quotients in Barrett's reduction
+    digits_type reciprocal_{};
+};
+
+} // namespace abacus::bignum
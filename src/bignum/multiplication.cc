@@ -0,0 +1,529 @@
+#include "kernels.hh"
+#include "stats.hh"
+#include "tuning.hh"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+
+namespace abacus::bignum::kernels {
+
+namespace {
+
+// Below these sizes, the recursive algorithms cannot split their operands
+auto static constexpr KARATSUBA_MINIMUM = std::size_t(2);
+auto static constexpr TOOM3_MINIMUM = std::size_t(3);
+
+void trim_leading_zeros(digits_type& num) {
+    num.resize(significant_size(num));
+}
+
+digits_type add_magnitudes(const_digits_span lhs, const_digits_span rhs) {
+    if (lhs.size() < rhs.size()) {
+        std::swap(lhs, rhs);
+    }
+
+    digits_type res(lhs.size() + 1);
+    res.back() = add(digits_span(res).first(lhs.size()), lhs, rhs);
+    trim_leading_zeros(res);
+
+    return res;
+}
+
+digits_type substract_magnitudes(const_digits_span lhs,
+                                 const_digits_span rhs) {
+    assert(compare(lhs, rhs) >= 0);
+
+    digits_type res(lhs.size());
+    [[maybe_unused]] auto const borrow = substract(res, lhs, rhs);
+    assert(borrow == 0);
+    trim_leading_zeros(res);
+
+    return res;
+}
+
+// Toom-3 evaluates its operands at negative points, which calls for a sign
+struct Signed {
+    Signed() = default;
+
+    Signed(const_digits_span num, bool negative = false)
+        : digits(num.begin(), num.begin() + significant_size(num)),
+          negative(negative && digits.size() != 0) {}
+
+    Signed(digits_type num, bool negative = false)
+        : digits(std::move(num)), negative(negative && digits.size() != 0) {}
+
+    digits_type digits{};
+    bool negative = false;
+};
+
+Signed operator-(Signed num) {
+    num.negative = !num.negative && num.digits.size() != 0;
+    return num;
+}
+
+Signed operator+(Signed const& lhs, Signed const& rhs) {
+    if (lhs.negative == rhs.negative) {
+        return {add_magnitudes(lhs.digits, rhs.digits), lhs.negative};
+    }
+
+    if (compare(lhs.digits, rhs.digits) >= 0) {
+        return {substract_magnitudes(lhs.digits, rhs.digits), lhs.negative};
+    }
+    return {substract_magnitudes(rhs.digits, lhs.digits), rhs.negative};
+}
+
+Signed operator-(Signed const& lhs, Signed const& rhs) {
+    return lhs + -rhs;
+}
+
+Signed operator*(Signed const& lhs, Signed const& rhs) {
+    if (lhs.digits.size() == 0 || rhs.digits.size() == 0) {
+        return {};
+    }
+
+    digits_type res(lhs.digits.size() + rhs.digits.size());
+    multiply(res, lhs.digits, rhs.digits);
+    trim_leading_zeros(res);
+
+    return {std::move(res), lhs.negative != rhs.negative};
+}
+
+Signed squared(Signed const& num) {
+    if (num.digits.size() == 0) {
+        return {};
+    }
+
+    digits_type res(2 * num.digits.size());
+    square(res, num.digits);
+    trim_leading_zeros(res);
+
+    return {std::move(res)};
+}
+
+Signed twice(Signed num) {
+    auto const carry = shift_left(num.digits, num.digits, 1);
+    if (carry != 0) {
+        num.digits.push_back(carry);
+    }
+    return num;
+}
+
+// The division must be exact
+Signed halve(Signed num) {
+    [[maybe_unused]] auto const remainder
+        = shift_right(num.digits, num.digits, 1);
+    assert(remainder == 0);
+    trim_leading_zeros(num.digits);
+    return num;
+}
+
+// The division must be exact
+Signed third(Signed num) {
+    [[maybe_unused]] auto const remainder
+        = divide_digit(num.digits, num.digits, 3);
+    assert(remainder == 0);
+    trim_leading_zeros(num.digits);
+    return num;
+}
+
+// Add a non-negative `num` to `res`, which must not overflow
+void add_into(digits_span res, Signed const& num) {
+    assert(!num.negative);
+    assert(res.size() >= num.digits.size());
+
+    [[maybe_unused]] auto const carry = add(res, res, num.digits);
+    assert(carry == 0);
+}
+
+// Chunks with an even index do not overlap in the result, and can be written to
+// it directly, as can the others once computed on the side. Only the carries
+// out of the latter then need to be propagated, in order
+void multiply_chunks_parallel(digits_span res, const_digits_span lhs,
+                              const_digits_span rhs) {
+    auto const chunks = (lhs.size() + rhs.size() - 1) / rhs.size();
+    auto const chunk = [&](std::size_t i) {
+        auto const offset = i * rhs.size();
+        return lhs.subspan(offset).first(
+            std::min(rhs.size(), lhs.size() - offset));
+    };
+
+    std::vector<digits_type> odd_products(chunks / 2);
+    std::vector<std::function<void()>> tasks;
+    for (std::size_t i = 0; i < chunks; ++i) {
+        tasks.push_back([&, i] {
+            auto const factor = chunk(i);
+            if (i % 2 == 0) {
+                auto const offset = i * rhs.size();
+                multiply(res.subspan(offset, factor.size() + rhs.size()),
+                         factor, rhs);
+            } else {
+                auto& product = odd_products[i / 2];
+                product = digits_type(factor.size() + rhs.size());
+                multiply(product, factor, rhs);
+            }
+        });
+    }
+    fork_join(tasks);
+
+    std::vector<digit_type> carries(odd_products.size());
+    tasks.clear();
+    for (std::size_t i = 0; i < odd_products.size(); ++i) {
+        tasks.push_back([&, i] {
+            auto const offset = (2 * i + 1) * rhs.size();
+            auto const& product = odd_products[i];
+            auto const range = res.subspan(offset, product.size());
+            carries[i] = add(range, range, product);
+        });
+    }
+    fork_join(tasks);
+
+    for (std::size_t i = 0; i < carries.size(); ++i) {
+        auto const end = (2 * i + 1) * rhs.size() + odd_products[i].size();
+        [[maybe_unused]] auto const carry
+            = add_digit(res.subspan(end), carries[i]);
+        assert(carry == 0);
+    }
+}
+
+// Cut `lhs` into `rhs`-sized chunks to multiply them in balanced fashion
+void multiply_unbalanced(digits_span res, const_digits_span lhs,
+                         const_digits_span rhs) {
+    assert(lhs.size() >= rhs.size());
+
+    std::fill(res.begin(), res.end(), 0);
+
+    if (can_fork()) {
+        multiply_chunks_parallel(res, lhs, rhs);
+        return;
+    }
+
+    digits_type product(2 * rhs.size());
+    for (std::size_t offset = 0; offset < lhs.size(); offset += rhs.size()) {
+        auto const chunk = lhs.subspan(offset).first(
+            std::min(rhs.size(), lhs.size() - offset));
+        auto const partial
+            = digits_span(product).first(chunk.size() + rhs.size());
+
+        multiply(partial, chunk, rhs);
+
+        [[maybe_unused]] auto const carry
+            = add(res.subspan(offset), res.subspan(offset), partial);
+        assert(carry == 0);
+    }
+}
+
+} // namespace
+
+void multiply_basecase(digits_span res, const_digits_span lhs,
+                       const_digits_span rhs) {
+    assert(res.size() == lhs.size() + rhs.size());
+
+    if (rhs.size() == 0) {
+        std::fill(res.begin(), res.end(), 0);
+        return;
+    }
+
+    res[lhs.size()] = multiply_digit(res.first(lhs.size()), lhs, rhs[0]);
+    for (std::size_t i = 1; i < rhs.size(); ++i) {
+        res[lhs.size() + i]
+            = add_multiply_digit(res.subspan(i, lhs.size()), lhs, rhs[i]);
+    }
+}
+
+void multiply_in_place(digits_span num, const_digits_span rhs) {
+    assert(num.size() >= rhs.size());
+
+    auto const size = num.size() - rhs.size();
+    stats::Scope counted(stats::Kernel::MultiplyBasecase,
+                         std::max(size, rhs.size()));
+    std::fill(num.begin() + size, num.end(), 0);
+
+    // Go from the most significant limb down, so that each one is read before
+    // being overwritten by the partial products
+    for (std::size_t i = size; i-- > 0;) {
+        auto const digit = num[i];
+        num[i] = 0;
+        auto const carry
+            = add_multiply_digit(num.subspan(i, rhs.size()), rhs, digit);
+        [[maybe_unused]] auto const overflow
+            = add_digit(num.subspan(i + rhs.size()), carry);
+        assert(overflow == 0);
+    }
+}
+
+void multiply_karatsuba(digits_span res, const_digits_span lhs,
+                        const_digits_span rhs) {
+    assert(res.size() == lhs.size() + rhs.size());
+    assert(lhs.size() >= rhs.size());
+    assert(2 * rhs.size() > lhs.size());
+
+    // Split both operands as `x1 * B^half + x0`
+    auto const half = lhs.size() / 2;
+    auto const lhs_low = lhs.first(half);
+    auto const lhs_high = lhs.subspan(half);
+    auto const rhs_low = rhs.first(half);
+    auto const rhs_high = rhs.subspan(half);
+
+    // `(x0 + x1) * (y0 + y1) - x0 * y0 - x1 * y1` gives the middle term
+    auto const lhs_sum = add_magnitudes(lhs_low, lhs_high);
+    auto const rhs_sum = add_magnitudes(rhs_low, rhs_high);
+
+    // The low and high products do not overlap in the result, and all three
+    // are independent
+    auto const low = res.first(2 * half);
+    auto const high = res.subspan(2 * half);
+    digits_type middle(lhs_sum.size() + rhs_sum.size());
+    fork_join(std::array<std::function<void()>, 3>{
+        [&] { multiply(low, lhs_low, rhs_low); },
+        [&] { multiply(high, lhs_high, rhs_high); },
+        [&] { multiply(middle, lhs_sum, rhs_sum); },
+    });
+
+    substract(middle, middle, low.first(significant_size(low)));
+    substract(middle, middle, high.first(significant_size(high)));
+
+    auto const shifted = res.subspan(half);
+    [[maybe_unused]] auto const carry = add(
+        shifted, shifted,
+        const_digits_span(middle).first(significant_size(middle)));
+    assert(carry == 0);
+}
+
+void multiply_toom3(digits_span res, const_digits_span lhs,
+                    const_digits_span rhs) {
+    assert(res.size() == lhs.size() + rhs.size());
+    assert(lhs.size() >= rhs.size());
+
+    // Split both operands as `x2 * B^2k + x1 * B^k + x0`
+    auto const k = (lhs.size() + 2) / 3;
+    assert(rhs.size() > 2 * k);
+
+    auto const lhs0 = lhs.first(k);
+    auto const lhs1 = lhs.subspan(k, k);
+    auto const lhs2 = lhs.subspan(2 * k);
+    auto const rhs0 = rhs.first(k);
+    auto const rhs1 = rhs.subspan(k, k);
+    auto const rhs2 = rhs.subspan(2 * k);
+
+    // Evaluation at 1, -1, and -2
+    auto const evaluate = [](auto x0, auto x1, auto x2) {
+        auto const outer = Signed(x0) + Signed(x2);
+        auto const at_one = outer + Signed(x1);
+        auto const at_minus_one = outer - Signed(x1);
+        auto const at_minus_two = twice(at_minus_one + Signed(x2)) - Signed(x0);
+        return std::make_tuple(at_one, at_minus_one, at_minus_two);
+    };
+    auto const [lhs_one, lhs_minus_one, lhs_minus_two]
+        = evaluate(lhs0, lhs1, lhs2);
+    auto const [rhs_one, rhs_minus_one, rhs_minus_two]
+        = evaluate(rhs0, rhs1, rhs2);
+
+    // Evaluation at 0 and infinity, which do not overlap in the result, and
+    // all five products are independent
+    auto const at_zero = res.first(2 * k);
+    auto const at_infinity = res.subspan(4 * k);
+    std::fill(res.begin() + 2 * k, res.begin() + 4 * k, 0);
+    Signed at_one, at_minus_one, at_minus_two;
+    fork_join(std::array<std::function<void()>, 5>{
+        [&] { multiply(at_zero, lhs0, rhs0); },
+        [&] { multiply(at_infinity, lhs2, rhs2); },
+        [&] { at_one = lhs_one * rhs_one; },
+        [&] { at_minus_one = lhs_minus_one * rhs_minus_one; },
+        [&] { at_minus_two = lhs_minus_two * rhs_minus_two; },
+    });
+
+    auto const r0 = Signed(const_digits_span(at_zero));
+    auto const r4 = Signed(const_digits_span(at_infinity));
+
+    // Bodrato's interpolation sequence
+    auto r3 = third(at_minus_two - at_one);
+    auto r1 = halve(at_one - at_minus_one);
+    auto r2 = at_minus_one - r0;
+    r3 = halve(r2 - r3) + twice(r4);
+    r2 = r2 + r1 - r4;
+    r1 = r1 - r3;
+
+    add_into(res.subspan(k), r1);
+    add_into(res.subspan(2 * k), r2);
+    add_into(res.subspan(3 * k), r3);
+}
+
+void multiply(digits_span res, const_digits_span lhs, const_digits_span rhs) {
+    assert(res.size() == lhs.size() + rhs.size());
+
+    if (lhs.data() == rhs.data() && lhs.size() == rhs.size()) {
+        square(res, lhs);
+        return;
+    }
+
+    if (lhs.size() < rhs.size()) {
+        std::swap(lhs, rhs);
+    }
+
+    auto const& tuning = thresholds();
+    ParallelScope scope(rhs.size());
+
+    // Unbalanced products are counted through the products of their chunks
+    using stats::Kernel;
+    if (rhs.size() < std::max(tuning.karatsuba, KARATSUBA_MINIMUM)) {
+        stats::Scope counted(Kernel::MultiplyBasecase, lhs.size());
+        multiply_basecase(res, lhs, rhs);
+    } else if (rhs.size() >= tuning.ntt) {
+        stats::Scope counted(Kernel::MultiplyNtt, lhs.size());
+        multiply_ntt(res, lhs, rhs);
+    } else if (2 * rhs.size() <= lhs.size()) {
+        multiply_unbalanced(res, lhs, rhs);
+    } else if (rhs.size() < std::max(tuning.toom3, TOOM3_MINIMUM)
+               || rhs.size() <= 2 * ((lhs.size() + 2) / 3)) {
+        stats::Scope counted(Kernel::MultiplyKaratsuba, lhs.size());
+        multiply_karatsuba(res, lhs, rhs);
+    } else {
+        stats::Scope counted(Kernel::MultiplyToom3, lhs.size());
+        multiply_toom3(res, lhs, rhs);
+    }
+}
+
+void square_basecase(digits_span res, const_digits_span num) {
+    assert(res.size() == 2 * num.size());
+
+    std::fill(res.begin(), res.end(), 0);
+
+    // Each cross product `num[i] * num[j]`, where `i < j`, appears twice
+    for (std::size_t i = 0; i + 1 < num.size(); ++i) {
+        auto const rest = num.subspan(i + 1);
+        res[i + num.size()]
+            = add_multiply_digit(res.subspan(2 * i + 1, rest.size()), rest,
+                                 num[i]);
+    }
+    if (num.size() != 0) {
+        [[maybe_unused]] auto const overflow = shift_left(res, res, 1);
+        assert(overflow == 0);
+    }
+
+    // Then add the squares on the diagonal
+    digit_type carry = 0;
+    for (std::size_t i = 0; i < num.size(); ++i) {
+        auto const square = double_digit_type(num[i]) * num[i];
+        auto const low = double_digit_type(res[2 * i]) + digit_type(square)
+                         + carry;
+        auto const high = double_digit_type(res[2 * i + 1])
+                          + digit_type(square >> DIGIT_BITS)
+                          + digit_type(low >> DIGIT_BITS);
+        res[2 * i] = digit_type(low);
+        res[2 * i + 1] = digit_type(high);
+        carry = digit_type(high >> DIGIT_BITS);
+    }
+    assert(carry == 0);
+}
+
+void square_karatsuba(digits_span res, const_digits_span num) {
+    assert(res.size() == 2 * num.size());
+    assert(num.size() >= KARATSUBA_MINIMUM);
+
+    // Split the operand as `x1 * B^half + x0`
+    auto const half = num.size() / 2;
+    auto const num_low = num.first(half);
+    auto const num_high = num.subspan(half);
+
+    // `(x0 + x1)^2 - x0^2 - x1^2` gives the middle term
+    auto const sum = add_magnitudes(num_low, num_high);
+
+    // The low and high squares do not overlap in the result, and all three
+    // are independent
+    auto const low = res.first(2 * half);
+    auto const high = res.subspan(2 * half);
+    digits_type middle(2 * sum.size());
+    fork_join(std::array<std::function<void()>, 3>{
+        [&] { square(low, num_low); },
+        [&] { square(high, num_high); },
+        [&] { square(middle, sum); },
+    });
+
+    substract(middle, middle, low.first(significant_size(low)));
+    substract(middle, middle, high.first(significant_size(high)));
+
+    auto const shifted = res.subspan(half);
+    [[maybe_unused]] auto const carry = add(
+        shifted, shifted,
+        const_digits_span(middle).first(significant_size(middle)));
+    assert(carry == 0);
+}
+
+void square_toom3(digits_span res, const_digits_span num) {
+    assert(res.size() == 2 * num.size());
+
+    // Split the operand as `x2 * B^2k + x1 * B^k + x0`
+    auto const k = (num.size() + 2) / 3;
+    assert(num.size() > 2 * k);
+
+    auto const num0 = num.first(k);
+    auto const num1 = num.subspan(k, k);
+    auto const num2 = num.subspan(2 * k);
+
+    // Evaluation at 1, -1, and -2, done once for both factors
+    auto const outer = Signed(num0) + Signed(num2);
+    auto const num_one = outer + Signed(num1);
+    auto const num_minus_one = outer - Signed(num1);
+    auto const num_minus_two = twice(num_minus_one + Signed(num2))
+                               - Signed(num0);
+
+    // Evaluation at 0 and infinity, which do not overlap in the result, and
+    // all five squares are independent
+    auto const at_zero = res.first(2 * k);
+    auto const at_infinity = res.subspan(4 * k);
+    std::fill(res.begin() + 2 * k, res.begin() + 4 * k, 0);
+    Signed at_one, at_minus_one, at_minus_two;
+    fork_join(std::array<std::function<void()>, 5>{
+        [&] { square(at_zero, num0); },
+        [&] { square(at_infinity, num2); },
+        [&] { at_one = squared(num_one); },
+        [&] { at_minus_one = squared(num_minus_one); },
+        [&] { at_minus_two = squared(num_minus_two); },
+    });
+
+    auto const r0 = Signed(const_digits_span(at_zero));
+    auto const r4 = Signed(const_digits_span(at_infinity));
+
+    // Bodrato's interpolation sequence
+    auto r3 = third(at_minus_two - at_one);
+    auto r1 = halve(at_one - at_minus_one);
+    auto r2 = at_minus_one - r0;
+    r3 = halve(r2 - r3) + twice(r4);
+    r2 = r2 + r1 - r4;
+    r1 = r1 - r3;
+
+    add_into(res.subspan(k), r1);
+    add_into(res.subspan(2 * k), r2);
+    add_into(res.subspan(3 * k), r3);
+}
+
+void square(digits_span res, const_digits_span num) {
+    assert(res.size() == 2 * num.size());
+
+    auto const& tuning = thresholds();
+    ParallelScope scope(num.size());
+
+    using stats::Kernel;
+    if (num.size() < std::max(tuning.karatsuba_square, KARATSUBA_MINIMUM)) {
+        stats::Scope counted(Kernel::SquareBasecase, num.size());
+        square_basecase(res, num);
+    } else if (num.size() >= tuning.ntt_square) {
+        stats::Scope counted(Kernel::SquareNtt, num.size());
+        square_ntt(res, num);
+    } else if (num.size() < std::max(tuning.toom3_square, TOOM3_MINIMUM)
+               || num.size() <= 2 * ((num.size() + 2) / 3)) {
+        stats::Scope counted(Kernel::SquareKaratsuba, num.size());
+        square_karatsuba(res, num);
+    } else {
+        stats::Scope counted(Kernel::SquareToom3, num.size());
+        square_toom3(res, num);
+    }
+}
+
+} // namespace abacus::bignum::kernels
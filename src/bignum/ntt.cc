@@ -0,0 +1,378 @@
+#include "kernels.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+
+namespace abacus::bignum::kernels {
+
+namespace {
+
+// Arithmetic modulo an odd number below 2^63, values being kept in Montgomery
+// form to avoid 128-bit divisions
+class Montgomery {
+public:
+    constexpr explicit Montgomery(digit_type modulus)
+        : modulus_(modulus),
+          // 2^128 mod modulus, used to enter Montgomery form
+          squared_radix_((-double_digit_type(modulus)) % modulus) {
+        assert(modulus % 2 == 1);
+        assert(modulus < (digit_type(1) << (DIGIT_BITS - 1)));
+
+        // Newton's iteration doubles the correct bits each step
+        digit_type inverse = modulus;
+        for (int i = 0; i < 5; ++i) {
+            inverse *= 2 - modulus * inverse;
+        }
+        negated_inverse_ = -inverse;
+    }
+
+    constexpr digit_type modulus() const {
+        return modulus_;
+    }
+
+    // Compute `num / 2^64` modulo the modulus
+    constexpr digit_type reduce(double_digit_type num) const {
+        digit_type const factor = digit_type(num) * negated_inverse_;
+        // Cannot overflow, since the modulus is below 2^63
+        digit_type const res
+            = (num + double_digit_type(factor) * modulus_) >> DIGIT_BITS;
+        return res >= modulus_ ? res - modulus_ : res;
+    }
+
+    constexpr digit_type multiply(digit_type lhs, digit_type rhs) const {
+        return reduce(double_digit_type(lhs) * rhs);
+    }
+
+    constexpr digit_type add(digit_type lhs, digit_type rhs) const {
+        auto const res = lhs + rhs;
+        return res >= modulus_ ? res - modulus_ : res;
+    }
+
+    constexpr digit_type substract(digit_type lhs, digit_type rhs) const {
+        return lhs >= rhs ? lhs - rhs : lhs + modulus_ - rhs;
+    }
+
+    constexpr digit_type to_montgomery(digit_type num) const {
+        return multiply(num % modulus_, squared_radix_);
+    }
+
+    constexpr digit_type from_montgomery(digit_type num) const {
+        return reduce(num);
+    }
+
+    // Both `base` and the result are in Montgomery form
+    constexpr digit_type power(digit_type base, digit_type exponent) const {
+        digit_type res = to_montgomery(1);
+        for (; exponent != 0; exponent >>= 1) {
+            if (exponent & 1) {
+                res = multiply(res, base);
+            }
+            base = multiply(base, base);
+        }
+        return res;
+    }
+
+    // Both `num` and the result are in Montgomery form
+    constexpr digit_type inverse(digit_type num) const {
+        return power(num, modulus_ - 2);
+    }
+
+private:
+    digit_type modulus_;
+    digit_type squared_radix_;
+    digit_type negated_inverse_ = 0;
+};
+
+struct NttPrime {
+    Montgomery arithmetic;
+    // Generator of the multiplicative group, in normal form
+    digit_type generator;
+    // Largest power of two dividing `modulus - 1`
+    unsigned max_log_size;
+};
+
+// Primes of the form `k * 2^n + 1`, whose product is above 2^183: enough to
+// recover coefficients of products up to 2^55 limbs long without rounding
+std::array<NttPrime, 3> constexpr PRIMES = {
+    NttPrime{Montgomery(4179340454199820289u), 3, 57},
+    NttPrime{Montgomery(2485986994308513793u), 5, 55},
+    NttPrime{Montgomery(1945555039024054273u), 5, 56},
+};
+
+// Powers of a root of unity of order `size`, for the first half of the circle
+digits_type compute_twiddles(NttPrime const& prime, std::size_t size,
+                             bool inverse) {
+    auto const& arithmetic = prime.arithmetic;
+    auto const exponent = (arithmetic.modulus() - 1) / size;
+
+    auto root = arithmetic.power(arithmetic.to_montgomery(prime.generator),
+                                 exponent);
+    if (inverse) {
+        root = arithmetic.inverse(root);
+    }
+
+    digits_type twiddles(std::max<std::size_t>(size / 2, 1));
+    twiddles[0] = arithmetic.to_montgomery(1);
+    for (std::size_t i = 1; i < twiddles.size(); ++i) {
+        twiddles[i] = arithmetic.multiply(twiddles[i - 1], root);
+    }
+    return twiddles;
+}
+
+// Smallest amount of values or butterflies worth handing over to a thread
+auto static constexpr PARALLEL_GRAIN = std::size_t(1) << 12;
+
+// Run `butterflies(start, first, last)` on the pairs `[first, last)` of each
+// block of `length` values starting at `start`, splitting long blocks across
+// threads, or groups of short ones
+template <typename Butterflies>
+void for_each_butterfly(std::size_t size, std::size_t length,
+                        Butterflies const& butterflies) {
+    auto const half = length / 2;
+    if (half >= PARALLEL_GRAIN) {
+        for (std::size_t start = 0; start < size; start += length) {
+            parallel_for(half, PARALLEL_GRAIN, [&](auto first, auto last) {
+                butterflies(start, first, last);
+            });
+        }
+        return;
+    }
+
+    parallel_for(size / length, PARALLEL_GRAIN / half,
+                 [&](auto first, auto last) {
+                     for (auto block = first; block < last; ++block) {
+                         butterflies(block * length, 0, half);
+                     }
+                 });
+}
+
+// Butterflies `[first, last)` of the block at `values`, everything being passed
+// by value so that writing the values cannot alias any of it
+void forward_butterflies(Montgomery const arithmetic, digit_type* values,
+                         digit_type const* twiddles, std::size_t half,
+                         std::size_t stride, std::size_t first,
+                         std::size_t last) {
+    for (auto i = first; i < last; ++i) {
+        auto const lhs = values[i];
+        auto const rhs = values[i + half];
+        values[i] = arithmetic.add(lhs, rhs);
+        values[i + half] = arithmetic.multiply(arithmetic.substract(lhs, rhs),
+                                               twiddles[i * stride]);
+    }
+}
+
+// Same as above, for the decimation-in-time butterflies
+void inverse_butterflies(Montgomery const arithmetic, digit_type* values,
+                         digit_type const* twiddles, std::size_t half,
+                         std::size_t stride, std::size_t first,
+                         std::size_t last) {
+    for (auto i = first; i < last; ++i) {
+        auto const lhs = values[i];
+        auto const rhs
+            = arithmetic.multiply(values[i + half], twiddles[i * stride]);
+        values[i] = arithmetic.add(lhs, rhs);
+        values[i + half] = arithmetic.substract(lhs, rhs);
+    }
+}
+
+// Decimation-in-frequency, from natural order to bit-reversed order. Values
+// are in normal form, twiddles in Montgomery form, so products stay normal
+void forward_transform(Montgomery const& arithmetic, digits_span values,
+                       digits_type const& twiddles) {
+    auto const size = values.size();
+    for (auto length = size; length >= 2; length /= 2) {
+        auto const half = length / 2;
+        auto const stride = size / length;
+        for_each_butterfly(size, length, [&](auto start, auto first,
+                                             auto last) {
+            forward_butterflies(arithmetic, values.data() + start,
+                                twiddles.data(), half, stride, first, last);
+        });
+    }
+}
+
+// Decimation-in-time, from bit-reversed order to natural order, using the
+// inverse twiddles. The result is not scaled down by the transform size
+void inverse_transform(Montgomery const& arithmetic, digits_span values,
+                       digits_type const& twiddles) {
+    auto const size = values.size();
+    for (std::size_t length = 2; length <= size; length *= 2) {
+        auto const half = length / 2;
+        auto const stride = size / length;
+        for_each_butterfly(size, length, [&](auto start, auto first,
+                                             auto last) {
+            inverse_butterflies(arithmetic, values.data() + start,
+                                twiddles.data(), half, stride, first, last);
+        });
+    }
+}
+
+// Cyclic convolution of the operands modulo the prime, in normal form. When
+// both are the same span, it is only transformed once
+digits_type convolve(NttPrime const& prime, const_digits_span lhs,
+                     const_digits_span rhs, std::size_t size) {
+    assert(std::countr_zero(size) <= int(prime.max_log_size));
+
+    auto const& arithmetic = prime.arithmetic;
+    auto const modulus = arithmetic.modulus();
+
+    auto const twiddles = compute_twiddles(prime, size, false);
+
+    auto const transform = [&](const_digits_span num) {
+        digits_type values(size, 0);
+        std::transform(num.begin(), num.end(), values.begin(),
+                       [=](auto digit) { return digit % modulus; });
+        forward_transform(arithmetic, values, twiddles);
+        return values;
+    };
+
+    auto const squaring = lhs.data() == rhs.data() && lhs.size() == rhs.size();
+
+    digits_type res, other;
+    if (squaring) {
+        res = transform(lhs);
+    } else {
+        fork_join(std::array<std::function<void()>, 2>{
+            [&] { res = transform(lhs); },
+            [&] { other = transform(rhs); },
+        });
+    }
+    auto const& transformed = squaring ? res : other;
+
+    // Each product is divided by 2^64, compensate it when scaling down
+    auto const scale = arithmetic.multiply(
+        arithmetic.to_montgomery(arithmetic.to_montgomery(1)),
+        arithmetic.inverse(arithmetic.to_montgomery(size)));
+
+    parallel_for(size, PARALLEL_GRAIN, [&](auto first, auto last) {
+        for (auto i = first; i < last; ++i) {
+            res[i] = arithmetic.multiply(res[i], transformed[i]);
+        }
+    });
+
+    inverse_transform(arithmetic, res, compute_twiddles(prime, size, true));
+
+    parallel_for(size, PARALLEL_GRAIN, [&](auto first, auto last) {
+        for (auto i = first; i < last; ++i) {
+            res[i] = arithmetic.multiply(res[i], scale);
+        }
+    });
+
+    return res;
+}
+
+} // namespace
+
+void multiply_ntt(digits_span res, const_digits_span lhs,
+                  const_digits_span rhs) {
+    assert(res.size() == lhs.size() + rhs.size());
+    assert(rhs.size() != 0);
+
+    auto const coefficients = lhs.size() + rhs.size() - 1;
+    auto const size = std::bit_ceil(coefficients);
+    assert(std::countr_zero(size) <= 55);
+
+    std::array<digits_type, PRIMES.size()> residues;
+    std::array<std::function<void()>, PRIMES.size()> convolutions;
+    for (std::size_t i = 0; i < PRIMES.size(); ++i) {
+        convolutions[i] = [&, i] {
+            residues[i] = convolve(PRIMES[i], lhs, rhs, size);
+        };
+    }
+    fork_join(convolutions);
+
+    // Garner's algorithm, writing each coefficient as
+    // `x0 + p0 * x1 + p0 * p1 * x2`, where `xi < pi`
+    auto const& [first, second, third] = PRIMES;
+    auto const& m1 = second.arithmetic;
+    auto const& m2 = third.arithmetic;
+    auto const p0 = first.arithmetic.modulus();
+    auto const p1 = m1.modulus();
+
+    auto const inverse_p0_p1 = m1.inverse(m1.to_montgomery(p0));
+    auto const inverse_p0_p2 = m2.inverse(m2.to_montgomery(p0));
+    auto const inverse_p1_p2 = m2.inverse(m2.to_montgomery(p1));
+    auto const p0_p1 = double_digit_type(p0) * p1;
+    auto const p0_p1_low = digit_type(p0_p1);
+    auto const p0_p1_high = digit_type(p0_p1 >> DIGIT_BITS);
+
+    // Write limbs `[begin, end)` of the result, returning the carry out
+    auto const recombine = [=, &residues](std::size_t begin, std::size_t end) {
+        // Running carry, three limbs wide
+        double_digit_type carry_low = 0;
+        digit_type carry_high = 0;
+
+        for (auto i = begin; i < end; ++i) {
+            if (i < coefficients) {
+                auto const x0 = residues[0][i];
+                auto const x1 = m1.multiply(
+                    m1.substract(residues[1][i], x0 % p1), inverse_p0_p1);
+                auto const x2_p0 = m2.multiply(
+                    m2.substract(residues[2][i], x0 % m2.modulus()),
+                    inverse_p0_p2);
+                auto const x2 = m2.multiply(
+                    m2.substract(x2_p0, x1 % m2.modulus()), inverse_p1_p2);
+
+                // Add `x0 + p0 * x1` to the lower part of the carry
+                auto const low
+                    = double_digit_type(x0) + double_digit_type(p0) * x1;
+                carry_low += low;
+                carry_high += carry_low < low;
+
+                // Add `p0 * p1 * x2`, which spans three limbs
+                auto const product_low = double_digit_type(p0_p1_low) * x2;
+                auto const product_high = double_digit_type(p0_p1_high) * x2;
+                carry_low += product_low;
+                carry_high += carry_low < product_low;
+                auto const middle = product_high << DIGIT_BITS;
+                carry_low += middle;
+                carry_high += carry_low < middle;
+                carry_high += digit_type(product_high >> DIGIT_BITS);
+            }
+
+            res[i] = digit_type(carry_low);
+            carry_low = (carry_low >> DIGIT_BITS)
+                        | (double_digit_type(carry_high) << DIGIT_BITS);
+            carry_high = 0;
+        }
+
+        return carry_low;
+    };
+
+    // Chunks of the result can be written independently, leaving carries of up
+    // to two limbs to add in afterwards
+    std::mutex carries_mutex;
+    std::vector<std::pair<std::size_t, double_digit_type>> carries;
+    parallel_for(res.size(), PARALLEL_GRAIN, [&](auto begin, auto end) {
+        auto const carry = recombine(begin, end);
+        std::lock_guard lock(carries_mutex);
+        carries.emplace_back(end, carry);
+    });
+
+    for (auto const& [end, carry] : carries) {
+        digit_type const limbs[] = {digit_type(carry),
+                                    digit_type(carry >> DIGIT_BITS)};
+        auto const rest = res.subspan(end);
+        auto const width = std::min<std::size_t>(rest.size(), 2);
+        assert(width == 2 || limbs[1] == 0);
+        assert(width >= 1 || limbs[0] == 0);
+        [[maybe_unused]] auto const overflow
+            = add(rest, rest, const_digits_span(limbs).first(width));
+        assert(overflow == 0);
+    }
+}
+
+void square_ntt(digits_span res, const_digits_span num) {
+    assert(res.size() == 2 * num.size());
+
+    multiply_ntt(res, num, num);
+}
+
+} // namespace abacus::bignum::kernels
@@ -0,0 +1,96 @@
+#include "kernels.hh"
+#include "tuning.hh"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "parallel/thread-pool.hh"
+
+namespace abacus::bignum::kernels {
+
+namespace {
+
+// Threads left to the operation running on this thread, zero at the top-level
+// where it may use all of `threads()`
+thread_local std::size_t budget = 0;
+
+std::size_t available_threads() {
+    return budget == 0 ? threads() : budget;
+}
+
+// Set the budget of this thread for its lifetime
+class Budget {
+public:
+    explicit Budget(std::size_t threads)
+        : previous_(std::exchange(budget, threads)) {}
+
+    ~Budget() {
+        budget = previous_;
+    }
+
+private:
+    std::size_t previous_;
+};
+
+} // namespace
+
+ParallelScope::ParallelScope(std::size_t size) : previous_(budget) {
+    if (size < thresholds().parallel) {
+        budget = 1;
+    }
+}
+
+ParallelScope::~ParallelScope() {
+    budget = previous_;
+}
+
+bool can_fork() {
+    return available_threads() > 1;
+}
+
+void fork_join(std::span<std::function<void()> const> tasks) {
+    auto const threads = available_threads();
+    if (threads <= 1 || tasks.size() <= 1) {
+        for (auto const& task : tasks) {
+            task();
+        }
+        return;
+    }
+
+    // Never use more than the allowed threads, grouping tasks if needed
+    auto const groups = std::min(threads, tasks.size());
+    auto const share = threads / groups;
+
+    std::vector<parallel::ThreadPool::Task> parts;
+    for (std::size_t group = 0; group < groups; ++group) {
+        parts.push_back([=] {
+            Budget scope(share);
+            for (auto i = group; i < tasks.size(); i += groups) {
+                tasks[i]();
+            }
+        });
+    }
+
+    parallel::default_pool().run_all(parts);
+}
+
+void parallel_for(std::size_t count, std::size_t grain,
+                  std::function<void(std::size_t, std::size_t)> const& body) {
+    grain = std::max<std::size_t>(grain, 1);
+    auto const parts = std::min(available_threads(), count / grain);
+    if (parts <= 1) {
+        body(0, count);
+        return;
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (std::size_t i = 0; i < parts; ++i) {
+        auto const first = count * i / parts;
+        auto const last = count * (i + 1) / parts;
+        tasks.push_back([&body, first, last] { body(first, last); });
+    }
+    fork_join(tasks);
+}
+
+} // namespace abacus::bignum::kernels
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <cassert>
+#include <cstddef>
+
+#include "stats.hh"
+
+namespace abacus::bignum {
+
+// A `std::vector`-like container storing up to `N` elements inline, only
+// allocating on the heap for longer sequences. Restricted to trivial types,
+// which are copied around as plain bytes.
+template <typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivial_v<T>);
+    static_assert(N > 0);
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = T const&;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using iterator = T*;
+    using const_iterator = T const*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    SmallVector() = default;
+
+    explicit SmallVector(size_type count, T const& value = T()) {
+        assign(count, value);
+    }
+
+    template <std::input_iterator It>
+    SmallVector(It first, It last) {
+        assign(first, last);
+    }
+
+    SmallVector(SmallVector const& other) {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept {
+        steal(other);
+    }
+
+    ~SmallVector() {
+        release();
+    }
+
+    SmallVector& operator=(SmallVector const& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    void assign(size_type count, T const& value) {
+        clear();
+        resize(count, value);
+    }
+
+    // The range may be our own elements, which then fit without growing, each
+    // one being read before it can be overwritten
+    template <std::input_iterator It>
+    void assign(It first, It last) {
+        clear();
+        if constexpr (std::forward_iterator<It>) {
+            reserve(std::distance(first, last));
+        }
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    iterator begin() {
+        return data_;
+    }
+
+    const_iterator begin() const {
+        return data_;
+    }
+
+    iterator end() {
+        return data_ + size_;
+    }
+
+    const_iterator end() const {
+        return data_ + size_;
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    pointer data() {
+        return data_;
+    }
+
+    const_pointer data() const {
+        return data_;
+    }
+
+    size_type size() const {
+        return size_;
+    }
+
+    size_type capacity() const {
+        return capacity_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    // Whether the elements are stored in the object itself
+    bool is_inline() const {
+        return data_ == inline_;
+    }
+
+    reference operator[](size_type i) {
+        assert(i < size_);
+        return data_[i];
+    }
+
+    const_reference operator[](size_type i) const {
+        assert(i < size_);
+        return data_[i];
+    }
+
+    reference front() {
+        return (*this)[0];
+    }
+
+    const_reference front() const {
+        return (*this)[0];
+    }
+
+    reference back() {
+        return (*this)[size_ - 1];
+    }
+
+    const_reference back() const {
+        return (*this)[size_ - 1];
+    }
+
+    void reserve(size_type capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+
+        // Copy before releasing, the old storage being freed
+        stats::count_allocation();
+        auto const data = new T[capacity];
+        std::copy(begin(), end(), data);
+        release();
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void resize(size_type size, T const& value = T()) {
+        if (size > capacity_) {
+            reserve(std::max(size, 2 * capacity_));
+        }
+        if (size > size_) {
+            std::fill(end(), begin() + size, value);
+        }
+        size_ = size;
+    }
+
+    void clear() {
+        size_ = 0;
+    }
+
+    void push_back(T const& value) {
+        if (size_ == capacity_) {
+            // `value` may be one of our elements, freed when growing
+            auto const copy = value;
+            reserve(2 * capacity_);
+            data_[size_++] = copy;
+            return;
+        }
+        data_[size_++] = value;
+    }
+
+    void pop_back() {
+        assert(size_ > 0);
+        --size_;
+    }
+
+    // Only erasing a suffix is supported, which is all trimming needs
+    iterator erase(const_iterator first, const_iterator last) {
+        assert(last == end());
+        auto const index = first - begin();
+        size_ = index;
+        return begin() + index;
+    }
+
+    friend bool operator==(SmallVector const& lhs, SmallVector const& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    void release() {
+        if (!is_inline()) {
+            delete[] data_;
+        }
+        data_ = inline_;
+        capacity_ = N;
+    }
+
+    // Take ownership of `other`'s elements, which must not own any memory
+    void steal(SmallVector& other) {
+        assert(is_inline());
+
+        if (other.is_inline()) {
+            std::copy(other.begin(), other.end(), inline_);
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_;
+            other.capacity_ = N;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    T* data_ = inline_;
+    size_type size_ = 0;
+    size_type capacity_ = N;
+    T inline_[N];
+};
+
+} // namespace abacus::bignum
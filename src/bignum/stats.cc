@@ -0,0 +1,180 @@
+#include "stats.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+
+namespace abacus::bignum::stats {
+
+namespace {
+
+#ifdef ABACUS_STATS
+struct AtomicCounters {
+    std::atomic<std::uint64_t> calls = 0;
+    std::atomic<std::uint64_t> limbs = 0;
+    std::atomic<std::uint64_t> max_limbs = 0;
+    std::atomic<std::uint64_t> allocations = 0;
+    std::atomic<std::uint64_t> nanoseconds = 0;
+    std::atomic<std::uint64_t> self_nanoseconds = 0;
+};
+
+std::array<AtomicCounters, KERNEL_COUNT>& counters() {
+    static std::array<AtomicCounters, KERNEL_COUNT> counters{};
+    return counters;
+}
+
+// Innermost scope of this thread, and the depth of each kernel's recursion
+thread_local Scope* current = nullptr;
+thread_local std::array<unsigned, KERNEL_COUNT> depth{};
+
+std::uint64_t now() {
+    auto const time = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+#endif
+
+} // namespace
+
+char const* name(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Add:
+        return "add";
+    case Kernel::Substract:
+        return "substract";
+    case Kernel::MultiplyBasecase:
+        return "multiply (basecase)";
+    case Kernel::MultiplyKaratsuba:
+        return "multiply (karatsuba)";
+    case Kernel::MultiplyToom3:
+        return "multiply (toom-3)";
+    case Kernel::MultiplyNtt:
+        return "multiply (ntt)";
+    case Kernel::SquareBasecase:
+        return "square (basecase)";
+    case Kernel::SquareKaratsuba:
+        return "square (karatsuba)";
+    case Kernel::SquareToom3:
+        return "square (toom-3)";
+    case Kernel::SquareNtt:
+        return "square (ntt)";
+    case Kernel::DivMod:
+        return "div_mod";
+    case Kernel::Halve:
+        return "halve";
+    case Kernel::Pow:
+        return "pow";
+    case Kernel::PowMod:
+        return "pow_mod";
+    case Kernel::Sqrt:
+        return "sqrt";
+    case Kernel::Read:
+        return "read";
+    case Kernel::Dump:
+        return "dump";
+    }
+    return "unknown";
+}
+
+Snapshot snapshot() {
+    Snapshot res{};
+#ifdef ABACUS_STATS
+    for (std::size_t i = 0; i < KERNEL_COUNT; ++i) {
+        auto const& counter = counters()[i];
+        res[i] = {
+            counter.calls,       counter.limbs,       counter.max_limbs,
+            counter.allocations, counter.nanoseconds, counter.self_nanoseconds,
+        };
+    }
+#endif
+    return res;
+}
+
+void reset() {
+#ifdef ABACUS_STATS
+    for (auto& counter : counters()) {
+        counter.calls = 0;
+        counter.limbs = 0;
+        counter.max_limbs = 0;
+        counter.allocations = 0;
+        counter.nanoseconds = 0;
+        counter.self_nanoseconds = 0;
+    }
+#endif
+}
+
+void report(std::ostream& out, Snapshot const& stats) {
+    if (!ENABLED) {
+        out << "statistics are disabled, build with ABACUS_STATS\n";
+        return;
+    }
+
+    auto const milliseconds = [](std::uint64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1e6;
+    };
+
+    auto const flags = out.flags();
+    out << std::left << std::setw(22) << "kernel" << std::right
+        << std::setw(10) << "calls" << std::setw(14) << "limbs"
+        << std::setw(12) << "max limbs" << std::setw(10) << "allocs"
+        << std::setw(12) << "total ms" << std::setw(12) << "self ms" << '\n';
+    out << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < KERNEL_COUNT; ++i) {
+        auto const& counter = stats[i];
+        if (counter.calls == 0) {
+            continue;
+        }
+        out << std::left << std::setw(22) << name(Kernel(i)) << std::right
+            << std::setw(10) << counter.calls << std::setw(14) << counter.limbs
+            << std::setw(12) << counter.max_limbs << std::setw(10)
+            << counter.allocations << std::setw(12)
+            << milliseconds(counter.nanoseconds) << std::setw(12)
+            << milliseconds(counter.self_nanoseconds) << '\n';
+    }
+    out.flags(flags);
+}
+
+#ifdef ABACUS_STATS
+Scope::Scope(Kernel kernel, std::size_t limbs)
+    : kernel_(kernel),
+      parent_(std::exchange(current, this)),
+      outermost_(depth[std::size_t(kernel)]++ == 0),
+      start_(now()) {
+    auto& counter = counters()[std::size_t(kernel)];
+    counter.calls.fetch_add(1, std::memory_order_relaxed);
+    counter.limbs.fetch_add(limbs, std::memory_order_relaxed);
+
+    auto max = counter.max_limbs.load(std::memory_order_relaxed);
+    while (max < limbs && !counter.max_limbs.compare_exchange_weak(
+               max, limbs, std::memory_order_relaxed)) {
+    }
+}
+
+Scope::~Scope() {
+    auto const elapsed = now() - start_;
+
+    auto& counter = counters()[std::size_t(kernel_)];
+    counter.self_nanoseconds.fetch_add(elapsed - nested_,
+                                       std::memory_order_relaxed);
+    if (outermost_) {
+        counter.nanoseconds.fetch_add(elapsed, std::memory_order_relaxed);
+    }
+
+    --depth[std::size_t(kernel_)];
+    current = parent_;
+    if (parent_ != nullptr) {
+        parent_->nested_ += elapsed;
+    }
+}
+
+void count_allocation() {
+    if (current != nullptr) {
+        counters()[std::size_t(current->kernel_)].allocations.fetch_add(
+            1, std::memory_order_relaxed);
+    }
+}
+#endif
+
+} // namespace abacus::bignum::stats
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <iosfwd>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace abacus::bignum::stats {
+
+// Counting is only done when built with `ABACUS_STATS`, see the CMake option
+// of the same name. Otherwise, instrumentation compiles down to nothing, and
+// all counters stay at zero.
+#ifdef ABACUS_STATS
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+enum class Kernel {
+    Add,
+    Substract,
+    MultiplyBasecase,
+    MultiplyKaratsuba,
+    MultiplyToom3,
+    MultiplyNtt,
+    SquareBasecase,
+    SquareKaratsuba,
+    SquareToom3,
+    SquareNtt,
+    DivMod,
+    Halve,
+    Pow,
+    PowMod,
+    Sqrt,
+    Read,
+    Dump,
+};
+
+inline constexpr std::size_t KERNEL_COUNT = std::size_t(Kernel::Dump) + 1;
+
+char const* name(Kernel kernel);
+
+struct Counters {
+    // Number of calls, including recursive ones
+    std::uint64_t calls = 0;
+    // Total and largest size of the largest operand of each call, in limbs
+    std::uint64_t limbs = 0;
+    std::uint64_t max_limbs = 0;
+    // Heap allocations of limbs done while it was the innermost kernel
+    std::uint64_t allocations = 0;
+    // Time spent in it, including and excluding the other kernels it called.
+    // Recursive calls are only timed once, and time is summed across threads.
+    std::uint64_t nanoseconds = 0;
+    std::uint64_t self_nanoseconds = 0;
+};
+
+using Snapshot = std::array<Counters, KERNEL_COUNT>;
+
+// Counters accumulated since the start of the process, or the last `reset`
+Snapshot snapshot();
+void reset();
+
+// Write a table of the counters of the kernels which were called
+void report(std::ostream& out, Snapshot const& stats);
+
+#ifdef ABACUS_STATS
+// Count a call to `kernel` on operands of `limbs` limbs, timing its lifetime
+class Scope {
+public:
+    Scope(Kernel kernel, std::size_t limbs);
+    ~Scope();
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+private:
+    friend void count_allocation();
+
+    Kernel kernel_;
+    // Enclosing scope on the same thread
+    Scope* parent_;
+    bool outermost_;
+    std::uint64_t start_;
+    // Time spent in nested scopes
+    std::uint64_t nested_ = 0;
+};
+
+// Count an allocation for the innermost kernel of the current thread
+void count_allocation();
+#else
+class Scope {
+public:
+    Scope(Kernel, std::size_t) {}
+};
+
+inline void count_allocation() {}
+#endif
+
+} // namespace abacus::bignum::stats
@@ -0,0 +1,15 @@
+#include "tuning.hh"
+
+namespace abacus::bignum {
+
+Thresholds& thresholds() {
+    static Thresholds thresholds{};
+    return thresholds;
+}
+
+std::size_t& threads() {
+    static std::size_t threads = 1;
+    return threads;
+}
+
+} // namespace abacus::bignum
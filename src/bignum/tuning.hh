@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+namespace abacus::bignum {
+
+// Operand sizes, in limbs, from which each multiplication, division, or
+// decimal conversion algorithm takes over. The defaults come from running the
+// `tune_thresholds` benchmark, run it again to adapt them to a given machine.
+// Accesses are not synchronized: they should only be modified before doing any
+// computation.
+struct Thresholds {
+    std::size_t karatsuba = 40;
+    std::size_t toom3 = 110;
+    std::size_t ntt = 250;
+    // Same as above for squarings, whose basecase is cheaper
+    std::size_t karatsuba_square = 70;
+    std::size_t toom3_square = 220;
+    std::size_t ntt_square = 500;
+    std::size_t recursive_division = 64;
+    std::size_t radix_conversion = 38;
+    // Modulus size from which Montgomery reductions are done with a couple of
+    // products, rather than a limb at a time
+    std::size_t montgomery_products = 1200;
+    // Size from which multiplications are split across threads, see `threads`
+    std::size_t parallel = 2048;
+};
+
+Thresholds& thresholds();
+
+// Number of threads a single operation may use, on the process-wide pool of
+// the `parallel` library. Defaults to one, i.e: running on the calling thread.
+// Same as above, it should only be modified before doing any computation.
+std::size_t& threads();
+
+} // namespace abacus::bignum
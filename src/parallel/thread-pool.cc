@@ -0,0 +1,187 @@
+#include "thread-pool.hh"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace abacus::parallel {
+
+namespace {
+
+// The pool and queue of the worker running on this thread, if any
+thread_local ThreadPool const* current_pool = nullptr;
+thread_local std::size_t current_index = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) : size_(threads) {
+    for (std::size_t i = 0; i <= size_; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+std::size_t ThreadPool::default_threads() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+std::size_t ThreadPool::size() const {
+    return size_;
+}
+
+void ThreadPool::submit(Task task) {
+    std::call_once(started_, [this] { start(); });
+
+    auto& queue = *queues_[current_queue()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    // Counted under the lock, so that a worker cannot miss the wake-up
+    bool waiters;
+    {
+        std::lock_guard lock(sleep_mutex_);
+        ++pending_;
+        waiters = waiters_ > 0;
+    }
+    wake_.notify_one();
+    if (waiters) {
+        changed_.notify_all();
+    }
+}
+
+void ThreadPool::wait(std::function<bool()> const& done) {
+    auto const index = current_queue();
+    while (!done()) {
+        if (auto task = take(index)) {
+            execute(task);
+            continue;
+        }
+
+        // Some other thread is running what we are waiting for, sleep until it
+        // is done or there is something to steal
+        std::unique_lock lock(sleep_mutex_);
+        ++waiters_;
+        changed_.wait(lock, [&] { return pending_ > 0 || done(); });
+        --waiters_;
+    }
+}
+
+void ThreadPool::run_all(std::span<Task const> tasks) {
+    std::atomic<std::size_t> remaining = tasks.size();
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    auto const run = [&](Task const& task) {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        --remaining;
+    };
+
+    for (std::size_t i = 1; i < tasks.size(); ++i) {
+        submit([&run, &task = tasks[i]] { run(task); });
+    }
+    if (!tasks.empty()) {
+        run(tasks.front());
+    }
+    wait([&] { return remaining == 0; });
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::start() {
+    for (std::size_t i = 0; i < size_; ++i) {
+        threads_.emplace_back([this, i] { work(i); });
+    }
+}
+
+void ThreadPool::work(std::size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    while (true) {
+        if (auto task = take(index)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+        if (stopping_) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::execute(Task const& task) {
+    task();
+
+    // Locked after the task's effects, so that a waiter cannot miss them
+    std::lock_guard lock(sleep_mutex_);
+    if (waiters_ > 0) {
+        changed_.notify_all();
+    }
+}
+
+ThreadPool::Task ThreadPool::take(std::size_t index) {
+    auto const pop = [this](Queue& queue, bool back) -> Task {
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return nullptr;
+        }
+
+        auto task = std::move(back ? queue.tasks.back() : queue.tasks.front());
+        if (back) {
+            queue.tasks.pop_back();
+        } else {
+            queue.tasks.pop_front();
+        }
+        --pending_;
+        return task;
+    };
+
+    if (auto task = pop(*queues_[index], true)) {
+        return task;
+    }
+
+    // Start with the next queue, to spread thieves around
+    for (std::size_t i = 1; i < queues_.size(); ++i) {
+        auto const victim = (index + i) % queues_.size();
+        if (auto task = pop(*queues_[victim], false)) {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+std::size_t ThreadPool::current_queue() const {
+    return current_pool == this ? current_index : size_;
+}
+
+ThreadPool& default_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace abacus::parallel
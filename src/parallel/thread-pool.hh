@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+namespace abacus::parallel {
+
+// A fixed set of worker threads, each with its own deque of tasks. Workers pop
+// their own tasks from the back, most recent first, and steal from the front of
+// the others' deques when they run out. Threads are only started on the first
+// submitted task, so that an unused pool costs nothing.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(std::size_t threads = default_threads());
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    // Number of hardware threads, at least one
+    static std::size_t default_threads();
+
+    std::size_t size() const;
+
+    // Queue `task`, on the calling worker's own deque if it is one of ours
+    void submit(Task task);
+
+    // Run queued tasks on the calling thread until `done` returns true, which
+    // lets a task wait for others without starving the pool
+    void wait(std::function<bool()> const& done);
+
+    // Run all of `tasks`, the calling thread taking part, and return once they
+    // are done, re-throwing the first exception thrown by any of them
+    void run_all(std::span<Task const> tasks);
+
+private:
+    struct Queue {
+        std::mutex mutex{};
+        std::deque<Task> tasks{};
+    };
+
+    void start();
+    void work(std::size_t index);
+    // Run `task`, then wake up the threads waiting for it
+    void execute(Task const& task);
+    // Take a task from the back of queue `index`, or steal one from the others
+    Task take(std::size_t index);
+    // Queue of the calling thread: its own for our workers, a shared one else
+    std::size_t current_queue() const;
+
+    std::size_t size_;
+    // One per worker, and a last one for tasks submitted from other threads
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_{};
+    std::once_flag started_{};
+
+    // Queued tasks, to put idle workers to sleep
+    std::atomic<std::size_t> pending_ = 0;
+    std::mutex sleep_mutex_{};
+    std::condition_variable wake_{};
+    bool stopping_ = false;
+    // Threads in `wait` with nothing to steal, woken up when a task is queued
+    // or done
+    std::size_t waiters_ = 0;
+    std::condition_variable changed_{};
+};
+
+// Pool shared by the whole process, with one worker per hardware thread
+ThreadPool& default_pool();
+
+} // namespace abacus::parallel
@@ -0,0 +1,112 @@
+#include "mapped-file.hh"
+
+#include <utility>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace abacus::parse {
+
+namespace {
+
+// Release consumed input by steps of this many bytes
+constexpr std::size_t RELEASE_GRAIN = std::size_t(64) << 20;
+
+// Null bytes flex needs at the end of its buffer
+constexpr std::size_t PADDING = 2;
+
+} // namespace
+
+std::optional<MappedFile> MappedFile::map(int fd, std::size_t max_size) {
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return std::nullopt;
+    }
+
+    auto const position = lseek(fd, 0, SEEK_CUR);
+    if (position < 0 || position > info.st_size) {
+        return std::nullopt;
+    }
+    auto const file_size = static_cast<std::size_t>(info.st_size);
+    auto const offset = static_cast<std::size_t>(position);
+    if (max_size < PADDING || file_size - offset > max_size - PADDING) {
+        return std::nullopt;
+    }
+
+    // Reserve zeroed memory for the file and its padding, then map the file
+    // over it: the padding is zeroed even when the file fills its last page
+    auto const length = file_size + PADDING;
+    auto* const reserved = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+        return std::nullopt;
+    }
+    if (file_size != 0
+        && mmap(reserved, file_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_FIXED, fd, 0)
+               == MAP_FAILED) {
+        munmap(reserved, length);
+        return std::nullopt;
+    }
+
+    madvise(reserved, length, MADV_SEQUENTIAL);
+
+    return MappedFile(static_cast<char*>(reserved), length, offset);
+}
+
+MappedFile::MappedFile(char* mapping, std::size_t length, std::size_t offset)
+    : mapping_(mapping), length_(length), offset_(offset) {}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      length_(std::exchange(other.length_, 0)),
+      offset_(std::exchange(other.offset_, 0)),
+      released_(std::exchange(other.released_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    if (this != &other) {
+        unmap();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        length_ = std::exchange(other.length_, 0);
+        offset_ = std::exchange(other.offset_, 0);
+        released_ = std::exchange(other.released_, 0);
+    }
+    return *this;
+}
+
+char* MappedFile::data() {
+    return mapping_ + offset_;
+}
+
+std::size_t MappedFile::size() const {
+    return length_ - offset_;
+}
+
+void MappedFile::release(char const* position) {
+    static auto const page_size = static_cast<std::size_t>(getpagesize());
+
+    auto const consumed = static_cast<std::size_t>(position - mapping_);
+    auto const end = consumed - consumed % page_size;
+    if (end < released_ + RELEASE_GRAIN) {
+        return;
+    }
+
+    // Pages written to by the scanner are private copies, which would
+    // otherwise stay around until the end
+    madvise(mapping_ + released_, end - released_, MADV_DONTNEED);
+    released_ = end;
+}
+
+void MappedFile::unmap() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, length_);
+        mapping_ = nullptr;
+    }
+}
+
+} // namespace abacus::parse
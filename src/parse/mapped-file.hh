@@ -0,0 +1,46 @@
+#pragma once
+
+#include <optional>
+
+#include <cstddef>
+
+namespace abacus::parse {
+
+// The contents of a regular file mapped in memory, followed by two null bytes
+// as expected by flex's `yy_scan_buffer`. The mapping is private, so the
+// scanner's writes into it never reach the file.
+class MappedFile {
+public:
+    // Map the rest of the file open as `fd`, from its current offset, or
+    // return nothing if it cannot be mapped, e.g: a pipe, or if it would be
+    // longer than `max_size` with its padding
+    static std::optional<MappedFile> map(int fd, std::size_t max_size);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+
+    // The contents of the file, including the trailing null bytes
+    char* data();
+    std::size_t size() const;
+
+    // Give the pages before `position` back to the system, as they will not
+    // be read again. Only done in large steps to keep it cheap to call often.
+    void release(char const* position);
+
+private:
+    MappedFile(char* mapping, std::size_t length, std::size_t offset);
+
+    void unmap();
+
+    // Page-aligned start of the whole mapping, and its length
+    char* mapping_ = nullptr;
+    std::size_t length_ = 0;
+    // Start of the contents in the mapping
+    std::size_t offset_ = 0;
+    // Amount of the mapping already given back
+    std::size_t released_ = 0;
+};
+
+} // namespace abacus::parse
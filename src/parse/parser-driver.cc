@@ -1,27 +1,131 @@
 #include "parser-driver.hh"
 
+#include <exception>
+#include <iostream>
+#include <utility>
+
+#include "ast/evaluate.hh"
+#include "ast/optimize.hh"
+#include "parallel/thread-pool.hh"
+#include "vm/compile.hh"
+
 namespace abacus::parse {
 
-ParserDriver::ParserDriver()
-    : parse_trace_p_(std::getenv("PARSE")), scan_trace_p_(std::getenv("SCAN")) {
-}
+ParserDriver::ParserDriver(std::ostream& errors)
+    : errors_(&errors),
+      parse_trace_p_(std::getenv("PARSE")),
+      scan_trace_p_(std::getenv("SCAN")) {}
 
 int ParserDriver::parse(std::string filename) {
     filename_ = std::move(filename);
+    output_ = nullptr;
+
+    int res = run_parser();
+
+    if (res == 0) {
+        root_ = ast::optimize(ast_, root_);
+        evaluate();
+    }
+
+    return res;
+}
+
+int ParserDriver::parse_string(std::string_view input) {
+    filename_.clear();
+    text_ = input;
+    output_ = nullptr;
 
-    current_location_.initialize(&filename_);
+    int res = run_parser();
+    text_.reset();
 
-    scan_open();
+    if (res == 0) {
+        root_ = ast::optimize(ast_, root_);
+        evaluate();
+    }
+
+    return res;
+}
+
+int ParserDriver::stream(std::string filename, std::ostream& output) {
+    filename_ = std::move(filename);
+    output_ = &output;
+    start_stream_ = true;
+    failed_ = false;
+
+    int res = run_parser();
+
+    output_ = nullptr;
+    return res != 0 || failed_;
+}
+
+int ParserDriver::run_parser() {
+    // Only name actual files in locations
+    current_location_.initialize(text_ ? nullptr : &filename_);
+    ast_.clear();
+
+    if (!scan_open()) {
+        return 1;
+    }
 
     yy::parser parser(*this);
     parser.set_debug_level(parse_trace_p_);
-    int res = parser.parse();
+    int res;
+    try {
+        res = parser.parse();
+    } catch (...) {
+        scan_close();
+        throw;
+    }
 
     scan_close();
 
     return res;
 }
 
+void ParserDriver::statement(ast::NodeId root, yy::location const& location) {
+    try {
+        root_ = ast::optimize(ast_, root);
+        evaluate();
+        *output_ << result_ << std::endl;
+    } catch (std::exception const& e) {
+        error(location, e.what());
+        failed_ = true;
+    }
+    ast_.clear();
+}
+
+void ParserDriver::error(yy::location const& location,
+                         std::string const& message) {
+    *errors_ << location << ": " << message << '\n';
+}
+
+void ParserDriver::skip_statement() {
+    ast_.clear();
+    failed_ = true;
+}
+
+void ParserDriver::release_input(char const* position) {
+    if (input_) {
+        input_->release(position);
+    }
+}
+
+bool ParserDriver::streaming() const {
+    return output_ != nullptr;
+}
+
+bool ParserDriver::start_stream() {
+    return std::exchange(start_stream_, false);
+}
+
+void ParserDriver::evaluate() {
+    result_ = ast::evaluate(ast_, root_, {}, parallel::default_pool());
+}
+
+void* ParserDriver::scanner() {
+    return scanner_;
+}
+
 yy::location& ParserDriver::location() {
     return current_location_;
 }
@@ -30,6 +134,26 @@ yy::location const& ParserDriver::location() const {
     return current_location_;
 }
 
+vm::Program ParserDriver::compile() const {
+    return vm::compile(ast_, root_);
+}
+
+ast::Ast& ParserDriver::ast() {
+    return ast_;
+}
+
+ast::Ast const& ParserDriver::ast() const {
+    return ast_;
+}
+
+ast::NodeId& ParserDriver::root() {
+    return root_;
+}
+
+ast::NodeId ParserDriver::root() const {
+    return root_;
+}
+
 ParserDriver::numeric_type& ParserDriver::result() {
     return result_;
 }
@@ -1,10 +1,22 @@
 #pragma once
 
+#include <iostream>
+#include <optional>
+#include <ostream>
 #include <string>
+#include <string_view>
 
+#include <cstdio>
+
+#include "mapped-file.hh"
 #include "parser.hh"
 
+#include "ast/ast.hh"
 #include "bignum/bignum.hh"
+#include "vm/bytecode.hh"
+
+// Flex's input buffers
+struct yy_buffer_state;
 
 namespace abacus::parse {
 
@@ -12,22 +24,84 @@ class ParserDriver {
 public:
     using numeric_type = abacus::bignum::BigNum;
 
-    ParserDriver();
+    // Errors are reported on `errors`
+    explicit ParserDriver(std::ostream& errors = std::cerr);
 
+    // Build the AST of the input, and optimize and evaluate it if it is
+    // well-formed
     int parse(std::string filename);
 
-    void scan_open();
+    // Same as `parse`, reading the expression from `input` rather than a file
+    int parse_string(std::string_view input);
+
+    // Parse newline or semicolon separated expressions, writing the result of
+    // each one to `output` as soon as it is read, on its own line. Erroneous
+    // expressions are reported and skipped, making the return value non-zero
+    int stream(std::string filename, std::ostream& output);
+
+    // Optimize, evaluate and output an expression read while streaming, then
+    // discard its AST
+    void statement(ast::NodeId root, yy::location const& location);
+    // Discard a statement which could not be parsed while streaming
+    void skip_statement();
+
+    // Report an error at the given location
+    void error(yy::location const& location, std::string const& message);
+
+    // Whether newlines separate expressions
+    bool streaming() const;
+    // True only for the first call when streaming, to select the grammar
+    bool start_stream();
+
+    // Compute the result again from the current AST
+    void evaluate();
+
+    // Turn the current AST into a program, to run it repeatedly
+    vm::Program compile() const;
+
+    // Set up the scanner on the input, reporting whether it could be opened
+    bool scan_open();
     void scan_close();
 
+    // The state of the reentrant scanner
+    void* scanner();
+
+    // Called by the scanner with the start of the next statement, when the
+    // previous ones are done with
+    void release_input(char const* position);
+
+    // Read the whole input, with the result of parsing it
+    int run_parser();
+
     yy::location& location();
     yy::location const& location() const;
 
+    ast::Ast& ast();
+    ast::Ast const& ast() const;
+
+    ast::NodeId& root();
+    ast::NodeId root() const;
+
     numeric_type& result();
     numeric_type const& result() const;
 
 private:
+    ast::Ast ast_{};
+    ast::NodeId root_ = 0;
     numeric_type result_{0};
     std::string filename_{};
+    // Input given directly, instead of a file
+    std::optional<std::string_view> text_{};
+    std::ostream* errors_;
+    // Each driver has its own scanner, so that they can run concurrently
+    void* scanner_ = nullptr;
+    std::FILE* file_ = nullptr;
+    // Regular files are scanned in place, without going through `yyin`
+    std::optional<MappedFile> input_{};
+    yy_buffer_state* buffer_ = nullptr;
+    std::ostream* output_ = nullptr;
+    bool start_stream_ = false;
+    bool failed_ = false;
     yy::location current_location_{};
     bool parse_trace_p_;
     bool scan_trace_p_;
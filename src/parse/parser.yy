@@ -13,6 +13,8 @@
 %define api.value.type variant
 // Define constructors for each token
 %define api.token.constructor
+// Move values out of the stack, to avoid copying number literals
+%define api.value.automove
 
 // Ambiguity is forbidden
 %expect 0
@@ -36,19 +38,47 @@ namespace abacus::parse {
 class ParserDriver;
 } // namespace abacus::parse
 
+#include <string>
+#include <vector>
+
+#include "ast/ast.hh"
 #include "bignum/bignum.hh"
 }
 
 %code provides {
-    // Forward ParserDriver to scanner
+    // Forward ParserDriver to the reentrant scanner, along with its state
     #define YY_DECL \
-        yy::parser::symbol_type yylex(::abacus::parse::ParserDriver& drv)
+        yy::parser::symbol_type yylex(::abacus::parse::ParserDriver& drv, \
+                                      void* yyscanner)
     YY_DECL;
 }
 
 // Only include the actual ParserDriver class declaration in source code
 %code {
 #include "parser-driver.hh"
+
+using abacus::ast::NodeId;
+using abacus::ast::Operation;
+
+// The parser only knows about the driver, which owns the scanner
+static yy::parser::symbol_type yylex(abacus::parse::ParserDriver& drv) {
+    return yylex(drv, drv.scanner());
+}
+
+// Build the node computing a call to a built-in function
+static NodeId call(abacus::parse::ParserDriver& drv,
+                   yy::parser::location_type const& loc,
+                   std::string const& name, std::vector<NodeId> const& args) {
+    if (name != "pow_mod") {
+        throw yy::parser::syntax_error(loc, "unknown function: " + name);
+    }
+    if (args.size() != 3) {
+        throw yy::parser::syntax_error(
+            loc, name + " expects 3 arguments, got "
+                     + std::to_string(args.size()));
+    }
+    return drv.ast().ternary(Operation::PowMod, args[0], args[1], args[2]);
+}
 }
 
 // Use the driver to carry context back-and-forth
@@ -57,9 +87,12 @@ class ParserDriver;
 %token EOF 0 "end-of-file"
 
 %token <abacus::bignum::BigNum> NUM "number"
+%token <std::string> IDENTIFIER "identifier"
 
 // Use `<<` to print everything
 %printer { yyo << $$; } <*>;
+%printer { yyo << $$.size() << " arguments"; }
+    <std::vector<abacus::ast::NodeId>>;
 
 %token
     PLUS "+"
@@ -68,33 +101,63 @@ class ParserDriver;
     DIVIDE "/"
     LPAREN "("
     RPAREN ")"
+    COMMA ","
+    SEPARATOR "separator"
+
+// Emitted first by the scanner when streaming, to select the grammar
+%token STREAM "start-of-stream"
 
 // Let's define the usual PEMDAS rules
 %left PLUS MINUS
 %left TIMES DIVIDE
 %precedence UNARY
 
-%type <abacus::bignum::BigNum> input exp
+// Expressions are built in the driver's AST, only their index goes on the stack
+%type <abacus::ast::NodeId> exp
+%type <std::vector<abacus::ast::NodeId>> arguments
 
 %%
 
 input:
-    exp EOF { drv.result() = $1; }
+    exp EOF { drv.root() = $1; }
+  | STREAM statements EOF
+  ;
+
+// Each expression is evaluated once its separator is read, so that its AST can
+// be discarded before parsing the next one
+statements:
+    statement
+  | statements SEPARATOR { yyerrok; } statement
+  ;
+
+// The rest of an erroneous statement is discarded up to its separator, after
+// which errors are reported again
+statement:
+    %empty
+  | exp { drv.statement($1, @1); }
+  | error { drv.skip_statement(); }
   ;
 
 exp:
-    NUM { $$ = $1; }
-  | exp PLUS exp { $$ = $1 + $3; }
-  | exp MINUS exp { $$ = $1 - $3; }
-  | exp TIMES exp { $$ = $1 * $3; }
-  | exp DIVIDE exp { $$ = $1 / $3; }
+    NUM { $$ = drv.ast().literal($1); }
+  | IDENTIFIER { $$ = drv.ast().variable($1); }
+  | exp PLUS exp { $$ = drv.ast().binary(Operation::Add, $1, $3); }
+  | exp MINUS exp { $$ = drv.ast().binary(Operation::Substract, $1, $3); }
+  | exp TIMES exp { $$ = drv.ast().binary(Operation::Multiply, $1, $3); }
+  | exp DIVIDE exp { $$ = drv.ast().binary(Operation::Divide, $1, $3); }
   | PLUS exp %prec UNARY { $$ = $2; }
-  | MINUS exp %prec UNARY { $$ = -$2; }
+  | MINUS exp %prec UNARY { $$ = drv.ast().unary(Operation::Negate, $2); }
   | LPAREN exp RPAREN { $$ = $2; }
+  | IDENTIFIER LPAREN arguments RPAREN { $$ = call(drv, @$, $1, $3); }
+  ;
+
+arguments:
+    exp { $$.push_back($1); }
+  | arguments COMMA exp { $$ = $1; $$.push_back($3); }
   ;
 
 %%
 
 void yy::parser::error(location_type const& l, std::string const& m) {
-  std::cerr << l << ": " << m << '\n';
+  drv.error(l, m);
 }
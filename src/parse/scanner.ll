@@ -1,5 +1,7 @@
 %{
-#include <sstream>
+#include <limits>
+#include <string_view>
+#include <utility>
 
 #include "parser-driver.hh"
 #include "parser.hh"
@@ -8,6 +10,9 @@
 %option noinput
 %option nounput
 
+/* Keep all state in the scanner, to allow for concurrent drivers */
+%option reentrant
+
 /* Enable scan tracing */
 %option debug
 
@@ -27,6 +32,7 @@
 
 blank [ \t\r]
 int [0-9]+
+identifier [a-zA-Z_][a-zA-Z_0-9]*
 
 %%
 
@@ -34,10 +40,25 @@ int [0-9]+
     // Run each time `yylex` is called
     auto& loc = drv.location();
     loc.step();
+
+    if (drv.start_stream()) {
+        return yy::parser::make_STREAM(loc);
+    }
 %}
 
 {blank}+    loc.step();
-\n+         loc.lines(yyleng); loc.step();
+\n          {
+    loc.lines(yyleng);
+    if (drv.streaming()) {
+        drv.release_input(yytext);
+        return yy::parser::make_SEPARATOR(loc);
+    }
+    loc.step();
+}
+";"         {
+    drv.release_input(yytext);
+    return yy::parser::make_SEPARATOR(loc);
+}
 
 "+"         return yy::parser::make_PLUS(loc);
 "-"         return yy::parser::make_MINUS(loc);
@@ -45,13 +66,16 @@ int [0-9]+
 "/"         return yy::parser::make_DIVIDE(loc);
 "("         return yy::parser::make_LPAREN(loc);
 ")"         return yy::parser::make_RPAREN(loc);
+","         return yy::parser::make_COMMA(loc);
 
 {int}       {
-    abacus::bignum::BigNum num;
-    std::stringstream(yytext) >> num;
-    return yy::parser::make_NUM(num, loc);
+    // Parse straight from the scanner's buffer
+    abacus::bignum::BigNum num(std::string_view(yytext, yyleng));
+    return yy::parser::make_NUM(std::move(num), loc);
 }
 
+{identifier} return yy::parser::make_IDENTIFIER(yytext, loc);
+
 .           {
     using namespace yy;
     using namespace std::string_literals;
@@ -64,19 +88,51 @@ int [0-9]+
 
 namespace abacus::parse {
 
-void ParserDriver::scan_open() {
-    yy_flex_debug = scan_trace_p_;
+bool ParserDriver::scan_open() {
+    if (text_) {
+        file_ = nullptr;
+    } else if (filename_.empty() || filename_ == "-") {
+        file_ = stdin;
+    } else if ((file_ = fopen(filename_.c_str(), "r")) == nullptr) {
+        *errors_ << "cannot open " << filename_ << ": " << strerror(errno)
+                 << '\n';
+        return false;
+    }
+
+    yylex_init(&scanner_);
+    yyset_debug(scan_trace_p_, scanner_);
+
+    // Scan a copy of the given input, terminated as flex expects it
+    if (text_) {
+        buffer_ = yy_scan_bytes(text_->data(), text_->size(), scanner_);
+        return true;
+    }
 
-    if (filename_.empty() || filename_ == "-") {
-        yyin = stdin;
-    } else if ((yyin = fopen(filename_.c_str(), "r")) == nullptr) {
-      std::cerr << "cannot open " << filename_ << ": " << strerror(errno) << '\n';
-      exit(EXIT_FAILURE);
+    yyset_in(file_, scanner_);
+
+    // Scan regular files straight from memory, rather than copying them into
+    // flex's buffers, which also lets literals be parsed in place. Flex keeps
+    // the size of its buffers in an `int`: longer files are read from `yyin`
+    auto constexpr max_size = std::size_t(std::numeric_limits<int>::max());
+    if ((input_ = MappedFile::map(fileno(file_), max_size))) {
+        buffer_ = yy_scan_buffer(input_->data(), input_->size(), scanner_);
     }
+
+    return true;
 }
 
 void ParserDriver::scan_close() {
-    fclose(yyin);
+    if (buffer_ != nullptr) {
+        yy_delete_buffer(buffer_, scanner_);
+        buffer_ = nullptr;
+    }
+    input_.reset();
+    yylex_destroy(scanner_);
+    scanner_ = nullptr;
+    if (file_ != nullptr) {
+        fclose(file_);
+        file_ = nullptr;
+    }
 }
 
 } // namespace abacus::parse
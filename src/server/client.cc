@@ -0,0 +1,78 @@
+// A minimal client for `abacus --serve`: sends its standard input to the
+// server, while writing the responses it gets back to its standard output
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Copy everything from `in` to `out`, returning whether it all went well
+bool copy(int in, int out) {
+    char buffer[1 << 16];
+    while (true) {
+        auto count = read(in, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return count == 0;
+        }
+        for (auto* it = buffer; count > 0;) {
+            auto const written = write(out, it, count);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written < 0) {
+                return false;
+            }
+            it += written;
+            count -= written;
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " SOCKET\n";
+        return EXIT_FAILURE;
+    }
+
+    std::string const path = argv[1];
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "socket path too long: " << path << '\n';
+        return EXIT_FAILURE;
+    }
+    path.copy(address.sun_path, path.size());
+
+    auto const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0
+        || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address))
+               != 0) {
+        std::cerr << "cannot connect to " << path << ": " << strerror(errno)
+                  << '\n';
+        return EXIT_FAILURE;
+    }
+
+    // Requests are sent without waiting for their responses, which are read
+    // concurrently, until the server is done answering them. It may stop
+    // early, with the sender still waiting on its input
+    std::thread([fd] {
+        copy(STDIN_FILENO, fd);
+        shutdown(fd, SHUT_WR);
+    }).detach();
+
+    return copy(fd, STDOUT_FILENO) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,252 @@
+#include "server.hh"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "parallel/thread-pool.hh"
+#include "parse/parser-driver.hh"
+
+namespace abacus::server {
+
+namespace {
+
+// Requests of a connection which may be in flight at once, which bounds the
+// memory used for a client sending them faster than they are answered
+constexpr std::size_t MAX_IN_FLIGHT = 256;
+
+[[noreturn]] void fail(char const* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+bool write_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+        // Do not get killed by `SIGPIPE` if the client went away
+        auto const written = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0) {
+            return false;
+        }
+        data.remove_prefix(written);
+    }
+    return true;
+}
+
+// Responses of a connection, written back in the order of their requests as
+// soon as they, and all the ones before them, are ready
+class Connection {
+public:
+    explicit Connection(int fd) : fd_(fd) {}
+
+    ~Connection() {
+        close(fd_);
+    }
+
+    Connection(Connection const&) = delete;
+    Connection& operator=(Connection const&) = delete;
+
+    int fd() const {
+        return fd_;
+    }
+
+    // Reserve the response to the next request, waiting for room if needed
+    std::size_t push() {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [&] { return responses_.size() < MAX_IN_FLIGHT; });
+        responses_.emplace_back();
+        return first_ + responses_.size() - 1;
+    }
+
+    void fulfill(std::size_t index, std::string response) {
+        std::lock_guard lock(mutex_);
+        responses_[index - first_] = std::move(response);
+        changed_.notify_all();
+    }
+
+    // No more requests will be pushed
+    void finish() {
+        std::lock_guard lock(mutex_);
+        finished_ = true;
+        changed_.notify_all();
+    }
+
+    // Write the responses until all of them are, after `finish`. If the client
+    // stops reading, the rest of them are dropped
+    void write_responses() {
+        bool broken = false;
+        while (true) {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [&] {
+                return (!responses_.empty() && responses_.front())
+                    || (responses_.empty() && finished_);
+            });
+            if (responses_.empty()) {
+                return;
+            }
+            auto response = std::move(*responses_.front());
+            responses_.pop_front();
+            ++first_;
+            changed_.notify_all();
+            lock.unlock();
+
+            response.push_back('\n');
+            if (!broken && !write_all(fd_, response)) {
+                // Stop reading requests which cannot be answered
+                broken = true;
+                shutdown(fd_, SHUT_RD);
+            }
+        }
+    }
+
+private:
+    int fd_;
+    std::mutex mutex_{};
+    std::condition_variable changed_{};
+    // Responses still to be written, the front one being for request `first_`
+    std::deque<std::optional<std::string>> responses_{};
+    std::size_t first_ = 0;
+    bool finished_ = false;
+};
+
+// Read the requests of a connection, one per line, until it is closed
+void handle(std::shared_ptr<Connection> connection,
+            parallel::ThreadPool& pool) {
+    std::thread writer([connection] { connection->write_responses(); });
+
+    auto const dispatch = [&](std::string request) {
+        auto const index = connection->push();
+        pool.submit([connection, index, request = std::move(request)] {
+            connection->fulfill(index, respond(request));
+        });
+    };
+
+    std::string buffer;
+    char chunk[1 << 16];
+    while (true) {
+        auto const count = read(connection->fd(), chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+
+        // Only look for newlines in what was just read
+        auto start = std::size_t(0);
+        auto end = buffer.size();
+        buffer.append(chunk, count);
+        while ((end = buffer.find('\n', end)) != std::string::npos) {
+            dispatch(buffer.substr(start, end - start));
+            start = ++end;
+        }
+        buffer.erase(0, start);
+    }
+    // The last request may not end with a newline
+    if (!buffer.empty()) {
+        dispatch(std::move(buffer));
+    }
+
+    connection->finish();
+    writer.join();
+}
+
+int listen_on(std::string const& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("socket path too long: " + path);
+    }
+    path.copy(address.sun_path, path.size());
+
+    auto const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fail("socket");
+    }
+
+    // Do not leak the socket, keeping the error to report
+    auto const close_and_fail = [fd](char const* what) {
+        auto const error = errno;
+        close(fd);
+        errno = error;
+        fail(what);
+    };
+
+    // Replace the socket of a previous server, but nothing else
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        unlink(path.c_str());
+    }
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close_and_fail("bind");
+    }
+    if (listen(fd, SOMAXCONN) != 0) {
+        close_and_fail("listen");
+    }
+
+    return fd;
+}
+
+} // namespace
+
+std::string respond(std::string_view request) {
+    std::ostringstream errors;
+    parse::ParserDriver driver(errors);
+
+    try {
+        if (driver.parse_string(request) == 0) {
+            std::ostringstream res;
+            res << driver.result();
+            return res.str();
+        }
+    } catch (std::exception const& e) {
+        errors << e.what();
+    }
+
+    // Only keep the first line of the report
+    auto message = errors.str();
+    message.erase(std::min(message.find('\n'), message.size()));
+    return "error: " + message;
+}
+
+void serve(std::string const& path) {
+    auto const listener = listen_on(path);
+
+    // Requests get their own workers: were they queued on the pool of the
+    // computations, a thread waiting on its tasks could pick up a whole request
+    parallel::ThreadPool requests;
+
+    while (true) {
+        auto const fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            // The client may have given up before being accepted
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            fail("accept");
+        }
+
+        auto connection = std::make_shared<Connection>(fd);
+        std::thread(handle, std::move(connection), std::ref(requests)).detach();
+    }
+}
+
+} // namespace abacus::server
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace abacus::server {
+
+// Evaluate a single expression, returning its result, or its error message
+// prefixed with `error: `, on a single line without its newline
+std::string respond(std::string_view request);
+
+// Listen on a Unix socket at `path`, replacing a stale one. Each line sent on
+// a connection is answered with a line, in the same order, requests being
+// evaluated concurrently so that clients can pipeline them. Only returns by
+// throwing, if the socket cannot be set up.
+[[noreturn]] void serve(std::string const& path);
+
+} // namespace abacus::server
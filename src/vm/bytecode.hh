@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "bignum/bignum.hh"
+
+namespace abacus::vm {
+
+// Operands are designated by slots: the program's constants come first, then
+// its variables, then the registers of the machine running it
+using Slot = std::uint32_t;
+
+enum class Opcode : std::uint8_t {
+    Negate,
+    Square,
+    Add,
+    Substract,
+    Multiply,
+    Divide,
+    PowMod,
+};
+
+// Compute `lhs op rhs`, `op lhs` for unary operations, or `op(lhs, rhs, extra)`
+// for ternary ones, into a register. Unused operands are set to `lhs`
+struct Instruction {
+    Opcode op;
+    Slot dst;
+    Slot lhs;
+    Slot rhs;
+    Slot extra;
+};
+
+struct Program {
+    std::vector<bignum::BigNum> constants{};
+    // Names of the variables, in the order their values should be given
+    std::vector<std::string> variables{};
+    std::size_t registers = 0;
+    std::vector<Instruction> instructions{};
+    Slot result = 0;
+};
+
+} // namespace abacus::vm
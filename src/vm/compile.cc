@@ -0,0 +1,148 @@
+#include "compile.hh"
+
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <cassert>
+
+namespace abacus::vm {
+
+using ast::arity;
+using ast::NodeId;
+using ast::Operation;
+
+namespace {
+
+Opcode to_opcode(Operation op) {
+    switch (op) {
+    case Operation::Negate:
+        return Opcode::Negate;
+    case Operation::Square:
+        return Opcode::Square;
+    case Operation::Add:
+        return Opcode::Add;
+    case Operation::Substract:
+        return Opcode::Substract;
+    case Operation::Multiply:
+        return Opcode::Multiply;
+    case Operation::Divide:
+        return Opcode::Divide;
+    case Operation::PowMod:
+        return Opcode::PowMod;
+    case Operation::Literal:
+    case Operation::Variable:
+        break;
+    }
+
+    assert(false);
+    return Opcode::Negate;
+}
+
+} // namespace
+
+Program compile(ast::Ast const& ast, NodeId root) {
+    auto const nodes = ast.nodes();
+    assert(root < nodes.size());
+
+    auto const no_use = std::numeric_limits<NodeId>::max();
+
+    // Find the last user of each node needed by the root, going top-down: the
+    // first one encountered is the last one to be executed
+    std::vector<std::optional<NodeId>> last_use(root + 1);
+    last_use[root] = no_use;
+    for (auto id = root + 1; id-- > 0;) {
+        auto const& node = nodes[id];
+        if (!last_use[id] || arity(node.op) == 0) {
+            continue;
+        }
+        if (!last_use[node.lhs]) {
+            last_use[node.lhs] = id;
+        }
+        if (arity(node.op) >= 2 && !last_use[node.rhs]) {
+            last_use[node.rhs] = id;
+        }
+        if (arity(node.op) == 3 && !last_use[node.extra]) {
+            last_use[node.extra] = id;
+        }
+    }
+
+    Program res;
+    res.variables.assign(ast.variables().begin(), ast.variables().end());
+
+    for (NodeId id = 0; id <= root; ++id) {
+        if (last_use[id] && nodes[id].op == Operation::Literal) {
+            res.constants.push_back(ast.value(nodes[id]));
+        }
+    }
+
+    auto const first_register
+        = Slot(res.constants.size() + res.variables.size());
+
+    std::vector<Slot> slots(root + 1);
+    std::vector<Slot> free_registers;
+    Slot constant = 0;
+
+    auto const is_register = [&](Slot slot) { return slot >= first_register; };
+    auto const dies_at = [&](NodeId operand, NodeId id) {
+        return last_use[operand] == id && is_register(slots[operand]);
+    };
+
+    for (NodeId id = 0; id <= root; ++id) {
+        auto const& node = nodes[id];
+        if (!last_use[id]) {
+            continue;
+        }
+
+        if (node.op == Operation::Literal) {
+            slots[id] = constant++;
+            continue;
+        }
+        if (node.op == Operation::Variable) {
+            slots[id] = res.constants.size() + node.lhs;
+            continue;
+        }
+
+        auto const binary = arity(node.op) >= 2;
+        auto const ternary = arity(node.op) == 3;
+        auto const lhs_dies = dies_at(node.lhs, id);
+        auto const rhs_dies = binary && dies_at(node.rhs, id)
+                              && node.rhs != node.lhs;
+        auto const extra_dies = ternary && dies_at(node.extra, id)
+                                && node.extra != node.lhs
+                                && node.extra != node.rhs;
+
+        // Write over a dying operand, so that the operation is done in place
+        Slot dst;
+        if (lhs_dies) {
+            dst = slots[node.lhs];
+        } else if (rhs_dies) {
+            dst = slots[node.rhs];
+        } else if (extra_dies) {
+            dst = slots[node.extra];
+        } else if (!free_registers.empty()) {
+            dst = free_registers.back();
+            free_registers.pop_back();
+        } else {
+            dst = first_register + res.registers++;
+        }
+
+        if (lhs_dies && rhs_dies) {
+            free_registers.push_back(slots[node.rhs]);
+        }
+        if ((lhs_dies || rhs_dies) && extra_dies) {
+            free_registers.push_back(slots[node.extra]);
+        }
+
+        res.instructions.push_back({to_opcode(node.op), dst, slots[node.lhs],
+                                    slots[binary ? node.rhs : node.lhs],
+                                    slots[ternary ? node.extra : node.lhs]});
+        slots[id] = dst;
+    }
+
+    res.result = slots[root];
+
+    return res;
+}
+
+} // namespace abacus::vm
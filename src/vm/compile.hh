@@ -0,0 +1,14 @@
+#pragma once
+
+#include "bytecode.hh"
+
+#include "ast/ast.hh"
+
+namespace abacus::vm {
+
+// Turn the expression rooted at `root` into a program, re-using the register
+// of each value after its last use, preferably for the operation consuming it
+// to be done in place.
+Program compile(ast::Ast const& ast, ast::NodeId root);
+
+} // namespace abacus::vm
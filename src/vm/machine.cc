@@ -0,0 +1,106 @@
+#include "machine.hh"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace abacus::vm {
+
+using bignum::BigNum;
+
+namespace {
+
+// Copying into an existing value re-uses its storage
+void assign(BigNum& dst, BigNum const& src) {
+    if (&dst != &src) {
+        dst = src;
+    }
+}
+
+void negate(BigNum& num) {
+    num = -std::move(num);
+}
+
+} // namespace
+
+BigNum const& Machine::run(Program const& program,
+                           std::span<BigNum const> variables) {
+    if (variables.size() < program.variables.size()) {
+        throw std::invalid_argument(
+            "unbound variable: " + program.variables[variables.size()]);
+    }
+
+    registers_.resize(std::max(registers_.size(), program.registers));
+
+    auto const constants = Slot(program.constants.size());
+    auto const first_register = Slot(constants + program.variables.size());
+
+    auto const read = [&](Slot slot) -> BigNum const& {
+        if (slot < constants) {
+            return program.constants[slot];
+        }
+        if (slot < first_register) {
+            return variables[slot - constants];
+        }
+        return registers_[slot - first_register];
+    };
+
+    for (auto const& instruction : program.instructions) {
+        auto& dst = registers_[instruction.dst - first_register];
+        auto const& lhs = read(instruction.lhs);
+        auto const& rhs = read(instruction.rhs);
+        auto const& extra = read(instruction.extra);
+
+        // The destination may be one of the operands, if it is no longer used
+        switch (instruction.op) {
+        case Opcode::Negate:
+            assign(dst, lhs);
+            negate(dst);
+            break;
+        case Opcode::Square:
+            assign(dst, lhs);
+            dst *= dst;
+            break;
+        case Opcode::Add:
+            if (&dst == &rhs) {
+                dst += lhs;
+            } else {
+                assign(dst, lhs);
+                dst += rhs;
+            }
+            break;
+        case Opcode::Substract:
+            if (&dst == &rhs) {
+                dst -= lhs;
+                negate(dst);
+            } else {
+                assign(dst, lhs);
+                dst -= rhs;
+            }
+            break;
+        case Opcode::Multiply:
+            if (&dst == &rhs) {
+                dst *= lhs;
+            } else {
+                assign(dst, lhs);
+                dst *= rhs;
+            }
+            break;
+        case Opcode::Divide:
+            if (&dst == &rhs) {
+                dst = lhs / rhs;
+            } else {
+                assign(dst, lhs);
+                dst /= rhs;
+            }
+            break;
+        case Opcode::PowMod:
+            dst = pow_mod(lhs, rhs, extra);
+            break;
+        }
+    }
+
+    return read(program.result);
+}
+
+} // namespace abacus::vm
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "bytecode.hh"
+
+#include "bignum/bignum.hh"
+
+namespace abacus::vm {
+
+// Runs programs, keeping its registers around to re-use their storage from one
+// run to the next.
+class Machine {
+public:
+    // Run `program`, with `variables` holding the values of its variables. The
+    // result is only valid until the next run
+    bignum::BigNum const& run(Program const& program,
+                              std::span<bignum::BigNum const> variables = {});
+
+private:
+    std::vector<bignum::BigNum> registers_{};
+};
+
+} // namespace abacus::vm
@@ -0,0 +1,301 @@
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ast/ast.hh"
+#include "ast/evaluate.hh"
+#include "ast/optimize.hh"
+#include "bignum/bignum.hh"
+#include "parallel/thread-pool.hh"
+
+using namespace abacus::ast;
+using abacus::bignum::BigNum;
+
+TEST(Ast, literal) {
+    Ast ast;
+    auto const forty_two = ast.literal(BigNum(42));
+
+    EXPECT_EQ(evaluate(ast, forty_two), BigNum(42));
+    // Evaluating does not consume the literals
+    EXPECT_EQ(evaluate(ast, forty_two), BigNum(42));
+}
+
+TEST(Ast, operations) {
+    Ast ast;
+    auto const one = ast.literal(BigNum(1));
+    auto const two = ast.literal(BigNum(2));
+    auto const three = ast.literal(BigNum(3));
+    auto const sum = ast.binary(Operation::Add, one, two);
+    auto const difference = ast.binary(Operation::Substract, one, three);
+    auto const product = ast.binary(Operation::Multiply, sum, difference);
+    auto const negation = ast.unary(Operation::Negate, product);
+    auto const quotient = ast.binary(Operation::Divide, negation, two);
+
+    EXPECT_EQ(evaluate(ast, sum), BigNum(3));
+    EXPECT_EQ(evaluate(ast, difference), BigNum(-2));
+    EXPECT_EQ(evaluate(ast, product), BigNum(-6));
+    EXPECT_EQ(evaluate(ast, negation), BigNum(6));
+    EXPECT_EQ(evaluate(ast, quotient), BigNum(3));
+}
+
+TEST(Ast, shared_operands) {
+    Ast ast;
+    auto const big = ast.literal(pow(BigNum(2), BigNum(300)) + BigNum(1));
+    auto const square = ast.binary(Operation::Multiply, big, big);
+    auto const twice = ast.binary(Operation::Add, square, square);
+    auto const zero = ast.binary(Operation::Substract, twice, twice);
+    auto const res = ast.binary(Operation::Add, zero, square);
+
+    auto const expected
+        = pow(pow(BigNum(2), BigNum(300)) + BigNum(1), BigNum(2));
+    EXPECT_EQ(evaluate(ast, twice), BigNum(2) * expected);
+    EXPECT_EQ(evaluate(ast, res), expected);
+}
+
+TEST(Ast, division_by_zero) {
+    Ast ast;
+    auto const one = ast.literal(BigNum(1));
+    auto const zero = ast.literal(BigNum(0));
+    auto const quotient = ast.binary(Operation::Divide, one, zero);
+
+    EXPECT_THROW(evaluate(ast, quotient), std::invalid_argument);
+}
+
+TEST(Ast, pow_mod) {
+    using enum Operation;
+
+    Ast ast;
+    auto const three = ast.literal(BigNum(3));
+    auto const big = ast.literal(pow(BigNum(10), BigNum(100)));
+    auto const modulus = ast.binary(Add, big, three);
+    auto const res = ast.ternary(PowMod, three, big, modulus);
+    auto const zero = ast.literal(BigNum(0));
+    auto const error = ast.ternary(PowMod, three, big, zero);
+
+    auto const expected = pow_mod(BigNum(3), pow(BigNum(10), BigNum(100)),
+                                  pow(BigNum(10), BigNum(100)) + BigNum(3));
+    EXPECT_EQ(evaluate(ast, res), expected);
+    EXPECT_THROW(evaluate(ast, error), std::invalid_argument);
+}
+
+TEST(Ast, variables) {
+    Ast ast;
+    auto const x = ast.variable("x");
+    auto const y = ast.variable("y");
+    auto const product = ast.binary(Operation::Multiply, x, y);
+    auto const square = ast.binary(Operation::Multiply, x, ast.variable("x"));
+
+    EXPECT_EQ(ast.variables().size(), 2);
+    auto const values = std::vector{BigNum(6), BigNum(-7)};
+    EXPECT_EQ(evaluate(ast, product, values), BigNum(-42));
+    EXPECT_EQ(evaluate(ast, square, values), BigNum(36));
+    EXPECT_THROW(evaluate(ast, product), std::invalid_argument);
+
+    // Optimizing keeps the variables' indices
+    auto const root = optimize(ast, square);
+    EXPECT_EQ(ast.variables().size(), 2);
+    EXPECT_EQ(ast.node(root).op, Operation::Square);
+    EXPECT_EQ(evaluate(ast, root, values), BigNum(36));
+
+    // Unbound variables are reported, even where their value does not matter
+    for (auto op : {Operation::Substract, Operation::Multiply}) {
+        Ast ast;
+        auto const x = ast.variable("x");
+        auto const rhs = op == Operation::Substract ? x
+                                                    : ast.literal(BigNum(0));
+        auto const root = optimize(ast, ast.binary(op, x, rhs));
+        EXPECT_THROW(evaluate(ast, root), std::invalid_argument);
+        EXPECT_EQ(evaluate(ast, root, values), BigNum(0));
+    }
+}
+
+TEST(Ast, clear) {
+    Ast ast;
+    ast.literal(BigNum(1));
+    EXPECT_FALSE(ast.empty());
+
+    ast.clear();
+    EXPECT_TRUE(ast.empty());
+
+    auto const two = ast.literal(BigNum(2));
+    EXPECT_EQ(two, 0);
+    EXPECT_EQ(evaluate(ast, two), BigNum(2));
+}
+
+TEST(Ast, optimize_sharing) {
+    Ast ast;
+    auto const big = pow(BigNum(3), BigNum(1000));
+    auto const x = ast.literal(big);
+    auto const y = ast.literal(big + BigNum(1));
+
+    // Sum of `(x * y)`, built anew each time, and of `(y * x)`
+    auto sum = ast.binary(Operation::Multiply, x, y);
+    for (int i = 0; i < 10; ++i) {
+        auto const lhs = ast.literal(big);
+        auto const rhs = ast.literal(big + BigNum(1));
+        auto const product = i % 2 == 0
+                                 ? ast.binary(Operation::Multiply, lhs, rhs)
+                                 : ast.binary(Operation::Multiply, rhs, lhs);
+        sum = ast.binary(Operation::Add, sum, product);
+    }
+
+    auto const root = optimize(ast, sum);
+    EXPECT_EQ(evaluate(ast, root), BigNum(11) * big * (big + BigNum(1)));
+
+    // Two literals, a single product, and the chain of sums
+    EXPECT_EQ(ast.nodes().size(), 2 + 1 + 10);
+}
+
+TEST(Ast, optimize_identities) {
+    auto const big = pow(BigNum(7), BigNum(500));
+
+    auto const check = [&](auto build, BigNum const& expected,
+                           std::size_t size) {
+        Ast ast;
+        auto const root = optimize(ast, build(ast, ast.literal(big)));
+        EXPECT_EQ(evaluate(ast, root), expected);
+        EXPECT_EQ(ast.nodes().size(), size);
+    };
+
+    using enum Operation;
+
+    // e + 0, 0 + e, e - 0, e * 1, 1 * e, e / 1
+    check([](Ast& ast, NodeId e) {
+        auto res = ast.binary(Add, e, ast.literal(BigNum(0)));
+        res = ast.binary(Add, ast.literal(BigNum(0)), res);
+        res = ast.binary(Substract, res, ast.literal(BigNum(0)));
+        res = ast.binary(Multiply, res, ast.literal(BigNum(1)));
+        res = ast.binary(Multiply, ast.literal(BigNum(1)), res);
+        return ast.binary(Divide, res, ast.literal(BigNum(1)));
+    }, big, 1);
+    // --e
+    check([](Ast& ast, NodeId e) {
+        return ast.unary(Negate, ast.unary(Negate, e));
+    }, big, 1);
+    // e - e, e * 0
+    check([](Ast& ast, NodeId e) {
+        auto const zero = ast.binary(Substract, e, e);
+        return ast.binary(Multiply, e, zero);
+    }, BigNum(0), 1);
+    // e * e
+    check([](Ast& ast, NodeId e) {
+        return ast.binary(Multiply, e, e);
+    }, big * big, 2);
+    // -e * -e
+    check([](Ast& ast, NodeId e) {
+        return ast.binary(Multiply, ast.unary(Negate, e), ast.unary(Negate, e));
+    }, big * big, 2);
+    // e + -e
+    check([](Ast& ast, NodeId e) {
+        return ast.binary(Add, e, ast.unary(Negate, e));
+    }, BigNum(0), 1);
+    // e * -1
+    check([](Ast& ast, NodeId e) {
+        return ast.binary(Multiply, e, ast.literal(BigNum(-1)));
+    }, -big, 2);
+    // Small literals are folded: e * (2 * 3 - 5)
+    check([](Ast& ast, NodeId e) {
+        auto const two = ast.literal(BigNum(2));
+        auto const three = ast.literal(BigNum(3));
+        auto const six = ast.binary(Multiply, two, three);
+        return ast.binary(Multiply, e,
+                          ast.binary(Substract, six, ast.literal(BigNum(5))));
+    }, big, 1);
+}
+
+TEST(Ast, optimize_keeps_errors) {
+    using enum Operation;
+
+    Ast ast;
+    auto const one = ast.literal(BigNum(1));
+    auto const zero = ast.literal(BigNum(0));
+    auto const quotient = ast.binary(Divide, one, zero);
+    auto const product = ast.binary(Multiply, quotient, zero);
+    auto const difference = ast.binary(Substract, product, product);
+
+    auto const root = optimize(ast, difference);
+    EXPECT_THROW(evaluate(ast, root), std::invalid_argument);
+}
+
+TEST(Ast, optimize_pow_mod) {
+    using enum Operation;
+
+    // Small operands are folded, whatever the size of the exponent
+    {
+        Ast ast;
+        auto const exponent = ast.literal(pow(BigNum(2), BigNum(200)));
+        auto const modulus = ast.unary(Negate, ast.literal(BigNum(1009)));
+        auto const three = ast.literal(BigNum(3));
+        auto const root
+            = optimize(ast, ast.ternary(PowMod, three, exponent, modulus));
+        EXPECT_EQ(ast.nodes().size(), 1);
+        EXPECT_EQ(evaluate(ast, root),
+                  pow_mod(BigNum(3), pow(BigNum(2), BigNum(200)),
+                          BigNum(1009)));
+    }
+
+    // A modulus which could be zero is kept
+    {
+        Ast ast;
+        auto const x = ast.variable("x");
+        auto const res = ast.ternary(PowMod, ast.literal(BigNum(2)), x, x);
+        auto const root = optimize(ast, ast.binary(Substract, res, res));
+        auto const values = std::vector{BigNum(0)};
+        EXPECT_THROW(evaluate(ast, root, values), std::invalid_argument);
+    }
+}
+
+TEST(Ast, parallel) {
+    using enum Operation;
+
+    abacus::parallel::ThreadPool pool(4);
+
+    // Cheap expressions are evaluated serially
+    Ast ast;
+    auto const x = ast.variable("x");
+    auto const y = ast.variable("y");
+    auto const small = ast.binary(Multiply, ast.binary(Add, x, y), y);
+    auto const small_values = std::vector{BigNum(2), BigNum(3)};
+    EXPECT_EQ(evaluate(ast, small, small_values, pool), BigNum(15));
+
+    // Independent products, some of them sharing operands
+    std::vector<NodeId> products;
+    for (int i = 0; i < 8; ++i) {
+        auto const shifted = ast.binary(Add, x, ast.literal(BigNum(i)));
+        products.push_back(ast.binary(Multiply, shifted, y));
+        products.push_back(ast.binary(Multiply, shifted, shifted));
+    }
+    while (products.size() > 1) {
+        std::vector<NodeId> next;
+        for (std::size_t i = 0; i < products.size(); i += 2) {
+            next.push_back(ast.binary(Substract, products[i], products[i + 1]));
+        }
+        products = std::move(next);
+    }
+    auto const root = ast.binary(Multiply, products[0], products[0]);
+
+    auto const values = std::vector{pow(BigNum(3), BigNum(20000)),
+                                    pow(BigNum(7), BigNum(10000))};
+    auto const expected = evaluate(ast, root, values);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(evaluate(ast, root, values, pool), expected);
+    }
+}
+
+TEST(Ast, parallel_errors) {
+    using enum Operation;
+
+    abacus::parallel::ThreadPool pool(4);
+
+    Ast ast;
+    auto const x = ast.variable("x");
+    auto const y = ast.variable("y");
+    auto const square = ast.binary(Multiply, x, x);
+    auto const zero = ast.binary(Substract, y, y);
+    auto const root = ast.binary(Add, square, ast.binary(Divide, square, zero));
+
+    auto const values = std::vector{pow(BigNum(3), BigNum(20000)), BigNum(1)};
+    EXPECT_THROW(evaluate(ast, root, values, pool), std::invalid_argument);
+    EXPECT_THROW(evaluate(ast, root, {}, pool), std::invalid_argument);
+}
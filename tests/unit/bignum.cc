@@ -1,11 +1,48 @@
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "bignum/bignum.hh"
+#include "bignum/expression.hh"
+#include "bignum/modular.hh"
+#include "bignum/small-vector.hh"
+#include "bignum/stats.hh"
+#include "bignum/tuning.hh"
 
 using namespace abacus::bignum;
 
+namespace {
+
+// Pseudo-random decimal digits, drawn from a linear congruential generator
+std::string random_decimal(std::size_t digits, std::uint64_t& state) {
+    std::string res;
+    for (std::size_t i = 0; i < digits; ++i) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        res.push_back('0' + (state >> 33) % 10);
+    }
+    return res;
+}
+
+// A number of exactly `digits` decimal digits
+BigNum random_num(std::size_t digits, std::uint64_t& state) {
+    auto str = random_decimal(digits, state);
+    str.front() = '9';
+    std::stringstream stream(str);
+    BigNum res;
+    EXPECT_TRUE(stream >> res);
+    return res;
+}
+
+} // namespace
+
 TEST(BigNum, dump) {
     auto const zero = BigNum(0);
     auto const one = BigNum(1);
@@ -38,6 +75,28 @@ TEST(BigNum, read) {
     EXPECT_EQ(from_str("42"), BigNum(42));
 }
 
+TEST(BigNum, from_string_view) {
+    EXPECT_EQ(BigNum(std::string_view("0")), BigNum(0));
+    EXPECT_EQ(BigNum(std::string_view("-0")), BigNum(0));
+    EXPECT_EQ(BigNum(std::string_view("-42")), BigNum(-42));
+    EXPECT_EQ(BigNum(std::string_view("000123")), BigNum(123));
+
+    // Every length, to go through all combinations of grouped digits
+    std::string const digits
+        = "31415926535897932384626433832795028841971693993751058209749445923"
+          "07816406286208998628034825342117067982148086513282306647093844609";
+    BigNum expected(0);
+    for (std::size_t i = 1; i <= digits.size(); ++i) {
+        expected = expected * BigNum(10) + BigNum(digits[i - 1] - '0');
+        EXPECT_EQ(BigNum(std::string_view(digits).substr(0, i)), expected);
+    }
+
+    EXPECT_THROW(BigNum(std::string_view("")), std::invalid_argument);
+    EXPECT_THROW(BigNum(std::string_view("-")), std::invalid_argument);
+    EXPECT_THROW(BigNum(std::string_view("+1")), std::invalid_argument);
+    EXPECT_THROW(BigNum(std::string_view("12a4")), std::invalid_argument);
+}
+
 TEST(BigNum, equality) {
     auto const zero = BigNum(0);
     auto const one = BigNum(1);
@@ -367,6 +426,150 @@ TEST(BigNum, pow_negative) {
     EXPECT_EQ(pow(three, four), eighty_one);
 }
 
+TEST(BigNum, pow_windows) {
+    auto const limb = pow(BigNum(2), BigNum(64));
+    // Large enough to use windows with its subquadratic products
+    auto const big = pow(BigNum(3), BigNum(2600)) + BigNum(2);
+
+    // Powers of two, bases with trailing zeros, and both small and large
+    // bases, for each of the window sizes
+    for (auto const& base :
+         {BigNum(2), BigNum(-4), BigNum(3), BigNum(10), BigNum(-12), limb,
+          limb * BigNum(6), limb * limb + BigNum(1), -big}) {
+        auto expected = BigNum(1);
+        for (std::int64_t exponent = 0; exponent <= 70; ++exponent) {
+            EXPECT_EQ(pow(base, BigNum(exponent)), expected);
+            expected *= base;
+        }
+
+        if (base.limb_count() > 2) {
+            continue;
+        }
+        for (std::int64_t exponent : {299, 1000, 4097}) {
+            auto const half = pow(base, BigNum(exponent / 2));
+            auto const expected = exponent % 2 == 0
+                                      ? half * half
+                                      : half * half * base;
+            EXPECT_EQ(pow(base, BigNum(exponent)), expected);
+        }
+    }
+}
+
+TEST(BigNum, pow_huge_exponent) {
+    auto const huge = pow(BigNum(2), BigNum(64)) + BigNum(1);
+
+    EXPECT_EQ(pow(BigNum(0), huge), BigNum(0));
+    EXPECT_EQ(pow(BigNum(1), huge), BigNum(1));
+    EXPECT_EQ(pow(BigNum(-1), huge), BigNum(-1));
+    EXPECT_EQ(pow(BigNum(-1), huge + BigNum(1)), BigNum(1));
+    EXPECT_THROW(pow(BigNum(2), huge), std::invalid_argument);
+}
+
+TEST(BigNum, pow_mod) {
+    auto const limb = pow(BigNum(2), BigNum(64));
+    // Long enough to reduce with subquadratic products
+    auto const big = pow(BigNum(3), BigNum(2600));
+
+    // Odd and even moduli, of a single limb, a few of them, and many
+    for (auto const& modulus :
+         {BigNum(7), BigNum(10), BigNum(-9), limb - BigNum(1), limb,
+          limb * limb, limb * limb - BigNum(3), big + BigNum(2),
+          big * BigNum(2), -big}) {
+        for (auto const& base :
+             {BigNum(2), BigNum(-3), limb + BigNum(5), big - BigNum(1),
+              big * big + BigNum(7), -(big * limb)}) {
+            auto power = BigNum(1);
+            for (std::int64_t exponent = 0; exponent <= 20; ++exponent) {
+                EXPECT_EQ(pow_mod(base, BigNum(exponent), modulus),
+                          power % modulus);
+                power = (power * base) % modulus;
+            }
+        }
+    }
+}
+
+TEST(BigNum, pow_mod_windows) {
+    auto const odd = pow(BigNum(2), BigNum(521)) - BigNum(1);
+    auto const even = pow(BigNum(10), BigNum(150));
+
+    // Exponents long enough to use each window size
+    for (auto const& modulus : {odd, even}) {
+        for (std::int64_t exponent : {63, 299, 1000, 4097}) {
+            auto const base = BigNum(3);
+            auto const half = pow_mod(base, BigNum(exponent / 2), modulus);
+            auto const expected = exponent % 2 == 0
+                                      ? half * half % modulus
+                                      : half * half * base % modulus;
+            EXPECT_EQ(pow_mod(base, BigNum(exponent), modulus), expected);
+        }
+    }
+}
+
+TEST(BigNum, pow_mod_fermat) {
+    // Mersenne primes, `a^(p - 1) = 1 (mod p)`
+    for (auto const exponent : {521, 1279}) {
+        auto const prime = pow(BigNum(2), BigNum(exponent)) - BigNum(1);
+        for (auto const base : {2, 3, 12345}) {
+            EXPECT_EQ(pow_mod(BigNum(base), prime - BigNum(1), prime),
+                      BigNum(1));
+        }
+    }
+}
+
+TEST(BigNum, pow_mod_edge_cases) {
+    auto const zero = BigNum(0);
+    auto const one = BigNum(1);
+    auto const three = BigNum(3);
+    auto const seven = BigNum(7);
+    auto const huge = pow(BigNum(2), BigNum(200)) + one;
+
+    EXPECT_EQ(pow_mod(three, zero, seven), one);
+    EXPECT_EQ(pow_mod(zero, zero, seven), one);
+    EXPECT_EQ(pow_mod(three, zero, one), zero);
+    EXPECT_EQ(pow_mod(three, huge, one), zero);
+    EXPECT_EQ(pow_mod(zero, three, seven), zero);
+    EXPECT_EQ(pow_mod(BigNum(14), three, seven), zero);
+    EXPECT_EQ(pow_mod(BigNum(-4), three, BigNum(8)), zero);
+    EXPECT_EQ(pow_mod(three, BigNum(-1), seven), zero);
+    EXPECT_EQ(pow_mod(BigNum(-3), three, seven), BigNum(-6));
+    EXPECT_EQ(pow_mod(three, huge, seven),
+              pow(three, huge % BigNum(6)) % seven);
+    EXPECT_THROW(pow_mod(three, three, zero), std::invalid_argument);
+}
+
+TEST(BigNum, modulus_reuse) {
+    auto const modulus = pow(BigNum(10), BigNum(40)) + BigNum(7);
+    auto const context = Modulus(modulus);
+
+    EXPECT_TRUE(context.matches(modulus));
+    EXPECT_TRUE(context.matches(-modulus));
+    EXPECT_FALSE(context.matches(modulus + BigNum(2)));
+
+    for (std::int64_t base = -5; base <= 5; ++base) {
+        EXPECT_EQ(context.pow(BigNum(base), BigNum(17)),
+                  pow(BigNum(base), BigNum(17)) % modulus);
+    }
+}
+
+TEST(BigNum, modulus_montgomery_products) {
+    auto const default_thresholds = thresholds();
+
+    // Reducing a limb at a time, or with products, for odd moduli of any size
+    for (auto limbs : {1, 2, 7, 45}) {
+        auto const modulus = pow(BigNum(3), BigNum(40 * limbs)) + BigNum(2);
+        auto const base = pow(BigNum(7), BigNum(50 * limbs));
+        auto const exponent = BigNum(1000003);
+
+        thresholds().montgomery_products = std::size_t(-1);
+        auto const expected = Modulus(modulus).pow(base, exponent);
+
+        thresholds().montgomery_products = 1;
+        EXPECT_EQ(Modulus(modulus).pow(base, exponent), expected);
+    }
+
+    thresholds() = default_thresholds;
+}
+
 TEST(BigNum, sqrt_zero) {
     auto const zero = BigNum(0);
 
@@ -388,6 +591,18 @@ TEST(BigNum, sqrt_truncation) {
     EXPECT_EQ(sqrt(three), one);
 }
 
+TEST(BigNum, sqrt_big) {
+    auto const two = BigNum(2);
+    auto const root = pow(BigNum(3), BigNum(200)) + BigNum(12345);
+    auto const square = root * root;
+
+    EXPECT_EQ(sqrt(square), root);
+    EXPECT_EQ(sqrt(square - BigNum(1)), root - BigNum(1));
+    EXPECT_EQ(sqrt(square + root + root), root);
+    EXPECT_EQ(sqrt(pow(two, BigNum(127))),
+              pow(two, BigNum(63)) + BigNum(3820445788478006404));
+}
+
 TEST(BigNum, sqrt) {
     auto const two = BigNum(2);
     auto const three = BigNum(3);
@@ -445,3 +660,597 @@ TEST(BigNum, log10) {
     EXPECT_EQ(log10(hundred), two);
     EXPECT_EQ(log10(hundred_one), two);
 }
+
+TEST(BigNum, bit_length) {
+    EXPECT_EQ(BigNum(0).bit_length(), 0);
+    EXPECT_EQ(BigNum(1).bit_length(), 1);
+    EXPECT_EQ(BigNum(-5).bit_length(), 3);
+
+    for (std::int64_t bits : {63, 64, 65, 128, 1000}) {
+        auto const power = pow(BigNum(2), BigNum(bits));
+        EXPECT_EQ((power - BigNum(1)).bit_length(), bits);
+        EXPECT_EQ(power.bit_length(), bits + 1);
+        EXPECT_EQ(log2(power + BigNum(1)), BigNum(bits));
+    }
+}
+
+TEST(BigNum, digit_count) {
+    auto const printed = [](BigNum const& num) {
+        std::ostringstream out;
+        out << num;
+        return out.str().size() - (num.is_negative() && !num.is_zero());
+    };
+
+    EXPECT_EQ(BigNum(0).digit_count(), 1);
+    EXPECT_EQ(BigNum(-12345).digit_count(), 5);
+
+    // Around each power of ten, where the top limbs do not suffice, and each
+    // power of two, where the bit length straddles two digit counts
+    auto power_of_ten = BigNum(1);
+    auto power_of_two = BigNum(1);
+    for (int i = 0; i < 700; ++i) {
+        for (auto const& power : {power_of_ten, power_of_two}) {
+            for (auto const& num :
+                 {power - BigNum(1), power, power + BigNum(1),
+                  power * BigNum(3), -power}) {
+                if (num.is_zero()) {
+                    continue;
+                }
+                EXPECT_EQ(num.digit_count(), printed(num)) << num;
+            }
+        }
+        power_of_ten *= BigNum(10);
+        power_of_two *= BigNum(2);
+    }
+
+    EXPECT_EQ(log10(power_of_ten - BigNum(1)), BigNum(699));
+    EXPECT_EQ(log10(power_of_ten), BigNum(700));
+}
+
+TEST(BigNum, dump_read_big) {
+    auto const to_str = [](auto num) {
+        std::stringstream str;
+        str << num;
+        return str.str();
+    };
+    auto const from_str = [](auto num) -> BigNum {
+        std::stringstream str(num);
+        BigNum res;
+        EXPECT_TRUE(str >> res);
+        return res;
+    };
+
+    auto const big = "123456789012345678901234567890"
+                     "123456789012345678901234567890";
+    auto const minus_big = "-1000000000000000000000000000000000000000";
+
+    EXPECT_EQ(to_str(from_str(big)), big);
+    EXPECT_EQ(to_str(from_str(minus_big)), minus_big);
+    EXPECT_EQ(to_str(from_str("000018446744073709551616")),
+              "18446744073709551616");
+}
+
+TEST(BigNum, limb_carry) {
+    auto const max = BigNum(std::numeric_limits<std::int64_t>::max());
+    auto const min = BigNum(std::numeric_limits<std::int64_t>::min());
+    auto const one = BigNum(1);
+
+    EXPECT_EQ(max + one, -min);
+    EXPECT_EQ(-min - one, max);
+    EXPECT_EQ((max + max + one + one) - max - max, one + one);
+}
+
+TEST(BigNum, multiplication_big) {
+    auto const from_str = [](auto num) -> BigNum {
+        std::stringstream str(num);
+        BigNum res;
+        EXPECT_TRUE(str >> res);
+        return res;
+    };
+
+    auto const lhs = from_str("123456789012345678901234567890");
+    auto const rhs = from_str("-987654321098765432109876543210");
+    auto const res
+        = from_str("-121932631137021795226185032733"
+                   "622923332237463801111263526900");
+
+    EXPECT_EQ(lhs * rhs, res);
+    EXPECT_EQ(rhs * lhs, res);
+}
+
+TEST(BigNum, div_mod_big) {
+    auto const from_str = [](auto num) -> BigNum {
+        std::stringstream str(num);
+        BigNum res;
+        EXPECT_TRUE(str >> res);
+        return res;
+    };
+
+    auto const lhs
+        = from_str("121932631137021795226185032733"
+                   "622923332237463801111263526917");
+    auto const rhs = from_str("987654321098765432109876543210");
+
+    EXPECT_EQ(lhs / rhs, from_str("123456789012345678901234567890"));
+    EXPECT_EQ(lhs % rhs, BigNum(17));
+    EXPECT_EQ((lhs / rhs) * rhs + (lhs % rhs), lhs);
+}
+
+TEST(BigNum, pow_big) {
+    auto const from_str = [](auto num) -> BigNum {
+        std::stringstream str(num);
+        BigNum res;
+        EXPECT_TRUE(str >> res);
+        return res;
+    };
+
+    EXPECT_EQ(pow(BigNum(3), BigNum(5)), BigNum(243));
+    EXPECT_EQ(pow(BigNum(2), BigNum(6)), BigNum(64));
+    EXPECT_EQ(pow(BigNum(2), BigNum(100)),
+              from_str("1267650600228229401496703205376"));
+    EXPECT_EQ(sqrt(pow(BigNum(2), BigNum(100))),
+              from_str("1125899906842624"));
+    EXPECT_EQ(log2(pow(BigNum(2), BigNum(100))), BigNum(100));
+    EXPECT_EQ(log10(pow(BigNum(10), BigNum(40))), BigNum(40));
+    EXPECT_EQ(log10(pow(BigNum(10), BigNum(40)) - BigNum(1)), BigNum(39));
+}
+
+TEST(BigNum, multiplication_algorithms) {
+    auto state = std::uint64_t(42);
+
+    auto const default_thresholds = thresholds();
+    std::size_t const sizes[] = {1, 20, 57, 200, 333, 1000, 2500, 4000};
+
+    for (auto lhs_size : sizes) {
+        for (auto rhs_size : sizes) {
+            auto const lhs = random_num(lhs_size, state);
+            auto const rhs = -random_num(rhs_size, state);
+
+            thresholds().karatsuba = std::size_t(-1);
+            thresholds().toom3 = std::size_t(-1);
+            thresholds().ntt = std::size_t(-1);
+            auto const expected = lhs * rhs;
+
+            thresholds().karatsuba = 2;
+            EXPECT_EQ(lhs * rhs, expected);
+
+            thresholds().toom3 = 3;
+            EXPECT_EQ(lhs * rhs, expected);
+
+            thresholds().ntt = 2;
+            EXPECT_EQ(lhs * rhs, expected);
+
+            thresholds() = default_thresholds;
+            EXPECT_EQ(lhs * rhs, expected);
+            EXPECT_EQ((lhs * rhs) / rhs, lhs);
+        }
+    }
+}
+
+TEST(BigNum, multiplication_ntt_carries) {
+    auto const default_thresholds = thresholds();
+
+    // All limbs saturated, to maximize the convolution's coefficients
+    auto const two = BigNum(2);
+    auto const bits = BigNum(64 * 300);
+    auto const num = pow(two, bits) - BigNum(1);
+    auto const expected = pow(two, bits + bits) - pow(two, bits + BigNum(1))
+                          + BigNum(1);
+
+    // Both the product of distinct operands, and the squaring of aliased ones
+    auto const copy = num;
+    thresholds().ntt = 2;
+    thresholds().ntt_square = 2;
+    EXPECT_EQ(num * copy, expected);
+    EXPECT_EQ(num * num, expected);
+
+    thresholds() = default_thresholds;
+}
+
+TEST(BigNum, square_algorithms) {
+    auto state = std::uint64_t(1729);
+
+    auto const default_thresholds = thresholds();
+    std::size_t const sizes[] = {1, 20, 38, 57, 77, 200, 333, 1000, 4000};
+
+    for (auto size : sizes) {
+        auto const num = -random_num(size, state);
+        // Distinct operands go through the multiplication algorithms
+        auto const copy = num;
+        auto const expected = num * copy;
+
+        thresholds().karatsuba_square = std::size_t(-1);
+        thresholds().toom3_square = std::size_t(-1);
+        thresholds().ntt_square = std::size_t(-1);
+        EXPECT_EQ(num * num, expected);
+
+        thresholds().karatsuba_square = 2;
+        EXPECT_EQ(num * num, expected);
+
+        thresholds().toom3_square = 3;
+        EXPECT_EQ(num * num, expected);
+
+        thresholds().ntt_square = 2;
+        EXPECT_EQ(num * num, expected);
+
+        threads() = 4;
+        thresholds().parallel = 2;
+        EXPECT_EQ(num * num, expected);
+        threads() = 1;
+
+        thresholds() = default_thresholds;
+        EXPECT_EQ(num * num, expected);
+        EXPECT_EQ(pow(num, BigNum(2)), expected);
+
+        auto squared = num;
+        squared *= squared;
+        EXPECT_EQ(squared, expected);
+    }
+}
+
+TEST(BigNum, multiplication_threads) {
+    auto const default_thresholds = thresholds();
+
+    auto state = std::uint64_t(7);
+
+    // Up to products long enough to split the NTT's loops
+    std::vector<BigNum> nums;
+    for (std::size_t digits : {1000, 6000, 100000}) {
+        nums.push_back(random_num(digits, state));
+    }
+
+    for (auto const& lhs : nums) {
+        for (auto const& num : nums) {
+            auto const rhs = -num;
+            auto const expected = lhs * rhs;
+            auto const division = div_mod(expected + lhs, rhs);
+
+            threads() = 4;
+            thresholds().parallel = 2;
+            // Split the recursion of Karatsuba and Toom-3
+            if (rhs.limb_count() < 1000) {
+                thresholds().ntt = std::size_t(-1);
+                EXPECT_EQ(lhs * rhs, expected);
+                thresholds().ntt = default_thresholds.ntt;
+            }
+
+            EXPECT_EQ(lhs * rhs, expected);
+            EXPECT_EQ(div_mod(expected + lhs, rhs), division);
+
+            threads() = 1;
+            thresholds() = default_thresholds;
+        }
+    }
+
+    // Parsing splits its conversion in the same way
+    threads() = 4;
+    thresholds().parallel = 2;
+    for (auto const& num : nums) {
+        std::stringstream stream;
+        stream << num;
+        EXPECT_EQ(BigNum(std::string_view(stream.str())), num);
+    }
+    threads() = 1;
+    thresholds() = default_thresholds;
+}
+
+TEST(BigNum, parallel_parsing) {
+    auto const default_thresholds = thresholds();
+    threads() = 4;
+    thresholds().parallel = 64;
+
+    auto state = std::uint64_t(11);
+    auto short_decimal = random_decimal(100'000, state);
+    auto long_decimal = random_decimal(2'000'000, state);
+    short_decimal.front() = '1';
+    long_decimal.front() = '1';
+
+    // Keep queueing the conversions of a number whose powers of ten are known,
+    // while squaring the longer powers forks and waits on the same pool
+    auto const short_num = BigNum(std::string_view(short_decimal));
+    std::atomic<bool> done = false;
+    auto background = std::thread([&] {
+        while (!done) {
+            EXPECT_EQ(BigNum(std::string_view(short_decimal)), short_num);
+        }
+    });
+    auto const long_num = BigNum(std::string_view(long_decimal));
+    done = true;
+    background.join();
+
+    threads() = 1;
+    thresholds() = default_thresholds;
+
+    std::stringstream stream;
+    stream << long_num;
+    EXPECT_EQ(stream.str(), long_decimal);
+}
+
+TEST(BigNum, div_mod_algorithm) {
+    auto state = std::uint64_t(1337);
+
+    auto const default_thresholds = thresholds();
+    std::size_t const sizes[] = {1, 19, 20, 40, 57, 200, 1000, 3000};
+
+    for (auto lhs_size : sizes) {
+        for (auto rhs_size : sizes) {
+            auto const lhs = random_num(lhs_size, state);
+            auto const rhs = random_num(rhs_size, state);
+
+            thresholds().recursive_division = std::size_t(-1);
+            auto const [quotient, remainder] = div_mod(lhs, rhs);
+
+            EXPECT_EQ(quotient * rhs + remainder, lhs);
+            EXPECT_GE(remainder, BigNum(0));
+            EXPECT_LT(remainder, rhs);
+
+            thresholds().recursive_division = 0;
+            EXPECT_EQ(div_mod(lhs, rhs), std::make_pair(quotient, remainder));
+
+            thresholds() = default_thresholds;
+            EXPECT_EQ(div_mod(lhs, rhs), std::make_pair(quotient, remainder));
+        }
+    }
+}
+
+TEST(BigNum, div_mod_add_back) {
+    auto const two = BigNum(2);
+    auto const limb = pow(two, BigNum(64));
+    auto const top = pow(two, BigNum(63));
+
+    // Cases where the estimated quotient digit is too large
+    auto const lhs = top * limb * limb + BigNum(3);
+    auto const rhs = top * limb + BigNum(1);
+    EXPECT_EQ((lhs / rhs) * rhs + (lhs % rhs), lhs);
+    EXPECT_LT(lhs % rhs, rhs);
+
+    auto const all_ones = pow(two, BigNum(64 * 4)) - BigNum(1);
+    auto const divisor = pow(two, BigNum(64 * 2)) - BigNum(1);
+    EXPECT_EQ(all_ones / divisor, pow(two, BigNum(64 * 2)) + BigNum(1));
+    EXPECT_EQ(all_ones % divisor, BigNum(0));
+}
+
+TEST(BigNum, dump_read_algorithms) {
+    auto const to_str = [](auto num) {
+        std::stringstream str;
+        str << num;
+        return str.str();
+    };
+    auto const from_str = [](auto num) -> BigNum {
+        std::stringstream str(num);
+        BigNum res;
+        EXPECT_TRUE(str >> res);
+        return res;
+    };
+
+    auto const default_thresholds = thresholds();
+
+    std::string decimal;
+    auto state = std::uint64_t(7);
+    for (std::size_t size : {1, 18, 19, 20, 38, 100, 1000, 5000, 20000}) {
+        decimal += random_decimal(size - decimal.size(), state);
+        decimal.front() = '1';
+
+        // Zeros in the middle test the padding of the lower halves
+        auto sparse = decimal;
+        std::fill(sparse.begin() + 1, sparse.begin() + (size + 1) / 2, '0');
+
+        for (auto radix_conversion : {std::size_t(1), std::size_t(-1)}) {
+            thresholds().radix_conversion = radix_conversion;
+            EXPECT_EQ(to_str(from_str(decimal)), decimal);
+            EXPECT_EQ(to_str(from_str(sparse)), sparse);
+            EXPECT_EQ(to_str(-from_str(decimal)), "-" + decimal);
+        }
+
+        thresholds() = default_thresholds;
+        EXPECT_EQ(to_str(from_str(decimal)), decimal);
+        EXPECT_EQ(log10(from_str(decimal)), BigNum(size - 1));
+    }
+}
+
+TEST(BigNum, inline_storage) {
+    auto const limb = pow(BigNum(2), BigNum(64));
+
+    // Grow through the inline capacity, and back down
+    auto num = BigNum(1);
+    std::vector<BigNum> powers;
+    for (int i = 0; i < 8; ++i) {
+        powers.push_back(num);
+        num *= limb;
+    }
+    for (int i = 8; i-- > 0;) {
+        num /= limb;
+        EXPECT_EQ(num, powers[i]);
+    }
+
+    for (auto const& power : powers) {
+        auto copy = power;
+        EXPECT_EQ(copy, power);
+        auto moved = std::move(copy);
+        EXPECT_EQ(moved, power);
+        copy = moved - BigNum(1);
+        EXPECT_EQ(copy + BigNum(1), power);
+        moved = std::move(copy);
+        EXPECT_EQ(moved + BigNum(1), power);
+    }
+}
+
+TEST(SmallVector, storage) {
+    using Vector = SmallVector<int, 2>;
+
+    auto vec = Vector();
+    EXPECT_TRUE(vec.is_inline());
+    EXPECT_TRUE(vec.empty());
+
+    vec.push_back(1);
+    vec.push_back(2);
+    EXPECT_TRUE(vec.is_inline());
+
+    vec.push_back(3);
+    EXPECT_FALSE(vec.is_inline());
+    EXPECT_EQ(vec.size(), 3);
+    EXPECT_EQ(vec.back(), 3);
+
+    auto const copy = vec;
+    EXPECT_EQ(copy, vec);
+
+    auto moved = std::move(vec);
+    EXPECT_EQ(moved, copy);
+    EXPECT_TRUE(vec.is_inline());
+    EXPECT_TRUE(vec.empty());
+
+    moved.erase(moved.begin() + 1, moved.end());
+    EXPECT_EQ(moved, Vector(1, 1));
+
+    vec = Vector(2, 7);
+    moved = std::move(vec);
+    EXPECT_TRUE(moved.is_inline());
+    EXPECT_EQ(moved, Vector(2, 7));
+
+    moved.resize(5, 4);
+    EXPECT_EQ(moved[1], 7);
+    EXPECT_EQ(moved[4], 4);
+}
+
+TEST(SmallVector, own_elements) {
+    using Vector = SmallVector<int, 2>;
+
+    // Pushing an element while growing, out of the inline storage then the heap
+    auto vec = Vector(2, 1);
+    vec.push_back(vec.back());
+    EXPECT_EQ(vec, Vector(3, 1));
+    vec.push_back(2);
+    vec.push_back(vec.back());
+    EXPECT_EQ(vec.size(), 5);
+    EXPECT_EQ(vec.capacity(), 8);
+    EXPECT_EQ(vec[4], 2);
+
+    // Assigning all or part of its own elements
+    auto const expected = Vector(vec.begin() + 3, vec.end());
+    vec.assign(vec.begin(), vec.end());
+    EXPECT_EQ(vec.size(), 5);
+    vec.assign(vec.begin() + 3, vec.end());
+    EXPECT_EQ(vec, expected);
+}
+
+TEST(BigNum, aliasing_operands) {
+    auto const limb = pow(BigNum(2), BigNum(64));
+
+    for (auto const& value : {BigNum(3), BigNum(-5), limb * limb + BigNum(7),
+                              -(limb * limb * limb * limb * limb)}) {
+        auto num = value;
+        num += num;
+        EXPECT_EQ(num, BigNum(2) * value);
+
+        num = value;
+        num -= num;
+        EXPECT_EQ(num, BigNum(0));
+
+        num = value;
+        num *= num;
+        EXPECT_EQ(num, pow(value, BigNum(2)));
+    }
+}
+
+TEST(BigNum, expiring_operands) {
+    auto const limb = pow(BigNum(2), BigNum(64));
+    auto const a = limb * limb * limb - BigNum(1);
+    auto const b = BigNum(-42);
+    auto const c = limb * limb * limb * limb * limb;
+
+    auto const copy = [](auto const& num) { return num; };
+
+    for (auto const& [lhs, rhs] :
+         {std::make_pair(a, b), std::make_pair(b, a), std::make_pair(a, c),
+          std::make_pair(c, b)}) {
+        auto const sum = lhs + rhs;
+        auto const difference = lhs - rhs;
+        auto const product = lhs * rhs;
+
+        EXPECT_EQ(copy(lhs) + rhs, sum);
+        EXPECT_EQ(lhs + copy(rhs), sum);
+        EXPECT_EQ(copy(lhs) + copy(rhs), sum);
+        EXPECT_EQ(copy(lhs) - rhs, difference);
+        EXPECT_EQ(lhs - copy(rhs), difference);
+        EXPECT_EQ(copy(lhs) - copy(rhs), difference);
+        EXPECT_EQ(copy(lhs) * rhs, product);
+        EXPECT_EQ(lhs * copy(rhs), product);
+        EXPECT_EQ(copy(lhs) * copy(rhs), product);
+        EXPECT_EQ(copy(lhs) / rhs, lhs / rhs);
+        EXPECT_EQ(copy(lhs) % rhs, lhs % rhs);
+        EXPECT_EQ(-copy(lhs), BigNum(0) - lhs);
+
+        EXPECT_EQ(sum - rhs, lhs);
+        EXPECT_EQ(product / rhs, lhs);
+    }
+}
+
+TEST(Expression, fused) {
+    using expression::lazy;
+
+    auto const limb = pow(BigNum(2), BigNum(64));
+    auto const a = limb * limb * limb - BigNum(1);
+    auto const b = BigNum(-42);
+    auto const c = -(limb * limb);
+    auto const d = pow(BigNum(3), BigNum(5000));
+
+    EXPECT_EQ(BigNum(lazy(a)), a);
+    EXPECT_EQ(BigNum(-lazy(b)), -b);
+    EXPECT_EQ(BigNum(lazy(a) + b), a + b);
+    EXPECT_EQ(BigNum(lazy(a) - b - c), a - b - c);
+    EXPECT_EQ(BigNum(a - lazy(a)), BigNum(0));
+    EXPECT_EQ(BigNum(lazy(a) * b + c), a * b + c);
+    EXPECT_EQ(BigNum(c - lazy(a) * b), c - a * b);
+    EXPECT_EQ(BigNum(-lazy(a) * -lazy(c)), a * c);
+    EXPECT_EQ(BigNum(lazy(d) * d - d * lazy(a) + a * lazy(c) - b),
+              d * d - d * a + a * c - b);
+    EXPECT_EQ(BigNum(lazy(a) + b + c + d + a + b + c + d),
+              BigNum(2) * (a + b + c + d));
+    EXPECT_EQ(BigNum(lazy(c) * c - c * c), BigNum(0));
+
+    // Carries and borrows ripple through the whole accumulator
+    auto const one = BigNum(1);
+    EXPECT_EQ(BigNum(lazy(a) + one), limb * limb * limb);
+    EXPECT_EQ(BigNum(lazy(one) - a - one), -a);
+    EXPECT_EQ(expression::evaluate(lazy(limb) * limb - one),
+              limb * limb - one);
+}
+
+TEST(BigNum, stats) {
+    using namespace abacus::bignum::stats;
+
+    reset();
+    // Large enough for its square to use the NTT
+    auto const big = pow(BigNum(3), BigNum(40000));
+    auto const quotient = (big * big + BigNum(1)) / big;
+    EXPECT_EQ(quotient, big);
+
+    auto const counters = snapshot();
+    auto const& square = counters[std::size_t(Kernel::SquareNtt)];
+    auto const& div_mod = counters[std::size_t(Kernel::DivMod)];
+    if (!ENABLED) {
+        EXPECT_EQ(square.calls, 0);
+        EXPECT_EQ(div_mod.calls, 0);
+        return;
+    }
+
+    EXPECT_GT(square.calls, 0);
+    EXPECT_EQ(square.max_limbs, big.limb_count());
+    EXPECT_GT(square.nanoseconds, 0);
+    EXPECT_GE(square.nanoseconds, square.self_nanoseconds);
+    EXPECT_GT(div_mod.calls, 0);
+    EXPECT_GT(div_mod.allocations, 0);
+    // Only the outermost division is timed as a whole
+    EXPECT_GE(div_mod.nanoseconds, div_mod.self_nanoseconds);
+
+    // Short products are done in place, and counted all the same
+    reset();
+    auto product = BigNum(3);
+    product *= big;
+    auto const basecase = snapshot()[std::size_t(Kernel::MultiplyBasecase)];
+    EXPECT_EQ(basecase.calls, 1);
+    EXPECT_EQ(basecase.max_limbs, big.limb_count());
+
+    reset();
+    EXPECT_EQ(snapshot()[std::size_t(Kernel::DivMod)].calls, 0);
+}
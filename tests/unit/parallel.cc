@@ -0,0 +1,102 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <ctime>
+
+#include <gtest/gtest.h>
+
+#include "parallel/thread-pool.hh"
+
+using namespace abacus::parallel;
+
+TEST(ThreadPool, runs_all_tasks) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+
+    std::atomic<int> sum = 0;
+    for (int i = 1; i <= 100; ++i) {
+        pool.submit([&sum, i] { sum += i; });
+    }
+    pool.wait([&] { return sum == 5050; });
+    EXPECT_EQ(sum, 5050);
+}
+
+TEST(ThreadPool, nested_tasks) {
+    ThreadPool pool(3);
+
+    // Tasks waiting on the tasks they submit, which need them to help out
+    std::atomic<int> leaves = 0;
+    std::function<void(int)> spawn = [&](int depth) {
+        if (depth == 0) {
+            ++leaves;
+            return;
+        }
+        std::atomic<int> done = 0;
+        for (int i = 0; i < 2; ++i) {
+            pool.submit([&, depth] {
+                spawn(depth - 1);
+                ++done;
+            });
+        }
+        pool.wait([&] { return done == 2; });
+    };
+
+    spawn(10);
+    EXPECT_EQ(leaves, 1024);
+}
+
+TEST(ThreadPool, without_workers) {
+    // The waiting thread runs everything itself
+    ThreadPool pool(0);
+
+    std::vector<std::thread::id> threads;
+    for (int i = 0; i < 3; ++i) {
+        pool.submit([&] { threads.push_back(std::this_thread::get_id()); });
+    }
+    pool.wait([&] { return threads.size() == 3; });
+
+    for (auto id : threads) {
+        EXPECT_EQ(id, std::this_thread::get_id());
+    }
+}
+
+TEST(ThreadPool, waiting_sleeps) {
+    ThreadPool pool(1);
+
+    auto const cpu_time = [] {
+        timespec time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return std::chrono::seconds(time.tv_sec)
+               + std::chrono::nanoseconds(time.tv_nsec);
+    };
+
+    // Nothing can be stolen while the only task runs
+    std::atomic<bool> done = false;
+    pool.submit([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto const start = cpu_time();
+    pool.wait([&] { return done.load(); });
+    EXPECT_LT(cpu_time() - start, std::chrono::milliseconds(50));
+}
+
+TEST(ThreadPool, run_all) {
+    ThreadPool pool(2);
+
+    std::atomic<int> count = 0;
+    std::vector<ThreadPool::Task> tasks(5, [&] { ++count; });
+    pool.run_all(tasks);
+    EXPECT_EQ(count, 5);
+
+    // The first exception is re-thrown once all tasks are done
+    tasks.push_back([] { throw std::runtime_error("failed"); });
+    EXPECT_THROW(pool.run_all(tasks), std::runtime_error);
+    EXPECT_EQ(count, 10);
+}
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "bignum/bignum.hh"
+#include "parse/mapped-file.hh"
+#include "parse/parser-driver.hh"
+
+using namespace abacus::parse;
+using abacus::bignum::BigNum;
+
+namespace {
+
+// Stream `input` from a file, returning the status and the output
+std::pair<int, std::string> stream(std::string_view input,
+                                   std::ostream& errors) {
+    auto const path = std::filesystem::temp_directory_path()
+                      / ("abacus-test-" + std::to_string(getpid()) + ".txt");
+    std::ofstream(path) << input;
+
+    std::ostringstream output;
+    ParserDriver driver(errors);
+    auto const res = driver.stream(path, output);
+    std::filesystem::remove(path);
+    return {res, output.str()};
+}
+
+} // namespace
+
+TEST(MappedFile, max_size) {
+    auto const path = std::filesystem::temp_directory_path()
+                      / ("abacus-test-" + std::to_string(getpid()) + ".txt");
+    std::ofstream(path) << std::string(100, '1');
+    auto const fd = open(path.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+
+    // The contents are followed by two null bytes
+    auto mapped = MappedFile::map(fd, 102);
+    ASSERT_TRUE(mapped);
+    EXPECT_EQ(mapped->size(), 102);
+    EXPECT_EQ(std::string_view(mapped->data(), 102),
+              std::string(100, '1') + std::string(2, '\0'));
+    EXPECT_FALSE(MappedFile::map(fd, 101));
+
+    // Only the rest of the file is mapped
+    lseek(fd, 10, SEEK_SET);
+    EXPECT_TRUE(MappedFile::map(fd, 92));
+    EXPECT_FALSE(MappedFile::map(fd, 91));
+
+    close(fd);
+    std::filesystem::remove(path);
+}
+
+TEST(ParserDriver, parse_string) {
+    std::ostringstream errors;
+    ParserDriver driver(errors);
+
+    EXPECT_EQ(driver.parse_string("1 + 2 * (3 - 4)"), 0);
+    EXPECT_EQ(driver.result(), BigNum(-1));
+
+    EXPECT_NE(driver.parse_string("1 + (2"), 0);
+    EXPECT_FALSE(errors.str().empty());
+}
+
+TEST(ParserDriver, concurrent_drivers) {
+    auto const large = std::string(100, '9');
+
+    // Each thread evaluates its own expressions, with its own driver
+    auto const work = [&](std::int64_t thread) {
+        std::ostringstream errors;
+        ParserDriver driver(errors);
+        for (std::int64_t i = 0; i < 500; ++i) {
+            auto const num = thread * 1000 + i;
+            auto const expression = std::to_string(num) + " * (" + large
+                                    + " - " + std::to_string(i) + ") / 3";
+            auto const expected
+                = BigNum(num) * (BigNum(std::string_view(large)) - BigNum(i))
+                  / BigNum(3);
+            if (driver.parse_string(expression) != 0
+                || driver.result() != expected) {
+                return false;
+            }
+        }
+        return errors.str().empty();
+    };
+
+    std::vector<std::thread> threads;
+    // Not a `std::vector<bool>`, whose elements cannot be set concurrently
+    std::vector<char> results(4, false);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&, i] { results[i] = work(i); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto ok : results) {
+        EXPECT_TRUE(ok);
+    }
+}
+
+TEST(ParserDriver, stream_separators) {
+    std::ostringstream errors;
+    EXPECT_EQ(stream("1 + 1; 2 * 3\n4; 5\n", errors),
+              std::pair(0, std::string("2\n6\n4\n5\n")));
+    EXPECT_EQ(stream("1\n\n;2;\n", errors),
+              std::pair(0, std::string("1\n2\n")));
+    EXPECT_TRUE(errors.str().empty());
+}
+
+TEST(ParserDriver, stream_errors) {
+    // Erroneous statements are reported, and the ones after them evaluated
+    std::ostringstream errors;
+    EXPECT_EQ(stream("1 +\n2 * 3; 1 / 0; 4\n5 )\n6\n", errors),
+              std::pair(1, std::string("6\n4\n6\n")));
+
+    std::string line;
+    std::vector<std::string> reported;
+    for (std::istringstream lines(errors.str()); std::getline(lines, line);) {
+        reported.push_back(line);
+    }
+    // Locations are prefixed with the file's name
+    ASSERT_EQ(reported.size(), 3) << errors.str();
+    EXPECT_NE(reported[0].find(":1."), std::string::npos) << reported[0];
+    EXPECT_NE(reported[1].find(":2."), std::string::npos) << reported[1];
+    EXPECT_NE(reported[2].find(":3."), std::string::npos) << reported[2];
+
+    // Even right after another one
+    std::ostringstream consecutive;
+    EXPECT_EQ(stream(") 1; 2 )\n3", consecutive),
+              std::pair(1, std::string("3\n")));
+    auto const report = consecutive.str();
+    EXPECT_EQ(std::count(report.begin(), report.end(), '\n'), 2) << report;
+}
+
+TEST(ParserDriver, stream_trailing_lines) {
+    std::ostringstream errors;
+    for (auto input : {"1\n2", "1\n2\n", "1\n2\n\n", "1\n2\n  \n"}) {
+        EXPECT_EQ(stream(input, errors), std::pair(0, std::string("1\n2\n")))
+            << input;
+    }
+    EXPECT_EQ(stream("", errors), std::pair(0, std::string()));
+    EXPECT_TRUE(errors.str().empty());
+}
@@ -0,0 +1,140 @@
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "server/server.hh"
+
+using namespace abacus::server;
+
+namespace {
+
+// Connect to the server at `path`, giving it some time to start listening
+int connect_to(std::string const& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+    for (int attempt = 0; attempt < 500; ++attempt) {
+        auto const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address))
+            == 0) {
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return -1;
+}
+
+} // namespace
+
+TEST(Server, respond) {
+    EXPECT_EQ(respond("1 + 2 * 3"), "7");
+    EXPECT_EQ(respond("pow_mod(4, 13, 497)"), "445");
+    EXPECT_TRUE(respond("(1 + 2").starts_with("error: "));
+    EXPECT_TRUE(respond("1 / 0").starts_with("error: "));
+}
+
+TEST(Server, setup_errors) {
+    auto const open_fds = [] {
+        auto const fds = std::filesystem::directory_iterator("/proc/self/fd");
+        return std::distance(begin(fds), end(fds));
+    };
+
+    auto const before = open_fds();
+    EXPECT_THROW(serve("/nonexistent/abacus.sock"), std::system_error);
+    EXPECT_THROW(serve(std::string(200, 'x')), std::invalid_argument);
+    EXPECT_EQ(open_fds(), before);
+}
+
+TEST(Server, pipelined_requests) {
+    auto const path = std::filesystem::temp_directory_path()
+                      / ("abacus-test-" + std::to_string(getpid()) + ".sock");
+    std::thread([path = path.string()] {
+        try {
+            serve(path);
+        } catch (std::exception const&) {
+            // Connecting to it fails the test
+        }
+    }).detach();
+
+    auto const fd = connect_to(path);
+    ASSERT_GE(fd, 0);
+
+    // A slow request first, which the quicker ones must not overtake, errors
+    // in-between, and a last one without its newline
+    auto const digits = std::string(400, '7');
+    std::vector<std::string> const kinds = {
+        "pow_mod(" + digits + ", " + digits + "9, " + digits + "1)",
+        "1 + 2",
+        "(",
+        "12345678901234567890 * 98765432109876543210",
+        "1 / 0",
+        "2 - 5 * 7",
+    };
+    std::vector<std::string> requests;
+    for (int i = 0; i < 50; ++i) {
+        requests.insert(requests.end(), kinds.begin(), kinds.end());
+    }
+
+    std::string sent;
+    for (auto const& request : requests) {
+        sent += request + '\n';
+    }
+    sent.pop_back();
+
+    // Send everything without waiting, while reading the responses
+    std::thread writer([&] {
+        for (std::string_view data = sent; !data.empty();) {
+            auto const written = send(fd, data.data(), data.size(), 0);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written < 0) {
+                break;
+            }
+            data.remove_prefix(written);
+        }
+        shutdown(fd, SHUT_WR);
+    });
+
+    std::string received;
+    char chunk[1 << 16];
+    while (true) {
+        auto const count = read(fd, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        received.append(chunk, count);
+    }
+    writer.join();
+    close(fd);
+    std::filesystem::remove(path);
+
+    std::string expected;
+    for (auto const& request : requests) {
+        expected += respond(request) + '\n';
+    }
+    EXPECT_EQ(received, expected);
+}
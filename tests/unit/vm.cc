@@ -0,0 +1,131 @@
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ast/ast.hh"
+#include "ast/evaluate.hh"
+#include "ast/optimize.hh"
+#include "bignum/bignum.hh"
+#include "vm/compile.hh"
+#include "vm/machine.hh"
+
+using namespace abacus::vm;
+using abacus::ast::Ast;
+using abacus::ast::NodeId;
+using abacus::ast::Operation;
+using abacus::bignum::BigNum;
+
+TEST(Vm, leaves) {
+    Machine machine;
+
+    Ast ast;
+    auto const forty_two = ast.literal(BigNum(42));
+    EXPECT_EQ(machine.run(compile(ast, forty_two)), BigNum(42));
+
+    auto const x = ast.variable("x");
+    auto const values = std::vector{BigNum(-1)};
+    EXPECT_EQ(machine.run(compile(ast, x), values), BigNum(-1));
+    EXPECT_THROW(machine.run(compile(ast, x)), std::invalid_argument);
+}
+
+TEST(Vm, operations) {
+    using enum Operation;
+
+    Ast ast;
+    auto const x = ast.variable("x");
+    auto const y = ast.variable("y");
+    auto const two = ast.literal(BigNum(2));
+    auto const sum = ast.binary(Add, x, y);
+    auto const difference = ast.binary(Substract, two, sum);
+    auto const product = ast.binary(Multiply, difference, x);
+    auto const square = ast.unary(Square, product);
+    auto const negation = ast.unary(Negate, square);
+    auto const root = ast.binary(Divide, negation, y);
+
+    auto const program = compile(ast, root);
+    EXPECT_EQ(program.variables, (std::vector<std::string>{"x", "y"}));
+
+    Machine machine;
+    for (auto const& [x, y] : {std::pair(BigNum(3), BigNum(-7)),
+                               std::pair(BigNum(-5), BigNum(4)),
+                               std::pair(pow(BigNum(10), BigNum(100)),
+                                         pow(BigNum(3), BigNum(50)))}) {
+        auto const values = std::vector{x, y};
+        auto const expected = -pow((BigNum(2) - (x + y)) * x, BigNum(2)) / y;
+        EXPECT_EQ(machine.run(program, values), expected);
+        EXPECT_EQ(evaluate(ast, root, values), expected);
+    }
+}
+
+TEST(Vm, operands_in_any_register) {
+    using enum Operation;
+
+    // Both operands of each operation are computed values, the right one
+    // dying first so that it is overwritten
+    Ast ast;
+    auto const x = ast.variable("x");
+    auto const one = ast.literal(BigNum(1));
+    auto const lhs = ast.binary(Add, x, one);
+    auto const rhs = ast.binary(Multiply, x, x);
+    auto const difference = ast.binary(Substract, lhs, rhs);
+    auto const quotient = ast.binary(Divide, rhs, lhs);
+    auto const root = ast.binary(Substract, quotient, difference);
+
+    auto const values = std::vector{BigNum(12345)};
+    Machine machine;
+    EXPECT_EQ(machine.run(compile(ast, root), values),
+              evaluate(ast, root, values));
+    EXPECT_EQ(machine.run(compile(ast, difference), values),
+              evaluate(ast, difference, values));
+}
+
+TEST(Vm, pow_mod) {
+    using enum Operation;
+
+    // Computed operands, all dying at the same operation
+    Ast ast;
+    auto const x = ast.variable("x");
+    auto const y = ast.variable("y");
+    auto const base = ast.binary(Add, x, y);
+    auto const exponent = ast.binary(Multiply, x, x);
+    auto const modulus = ast.binary(Substract, y, x);
+    auto const res = ast.ternary(PowMod, base, exponent, modulus);
+    auto const root = ast.binary(Add, res, ast.ternary(PowMod, x, y, x));
+
+    auto const program = compile(ast, root);
+    Machine machine;
+    for (auto const& [x, y] : {std::pair(BigNum(3), BigNum(100)),
+                               std::pair(pow(BigNum(10), BigNum(40)),
+                                         pow(BigNum(7), BigNum(80)))}) {
+        auto const values = std::vector{x, y};
+        auto const expected
+            = pow_mod(x + y, x * x, y - x) + pow_mod(x, y, x);
+        EXPECT_EQ(machine.run(program, values), expected);
+        EXPECT_EQ(evaluate(ast, root, values), expected);
+    }
+}
+
+TEST(Vm, register_reuse) {
+    using enum Operation;
+
+    // Sum of `x * (i + y)`
+    Ast ast;
+    auto const x = ast.variable("x");
+    auto const y = ast.variable("y");
+    auto sum = ast.literal(BigNum(0));
+    for (int i = 0; i < 100; ++i) {
+        auto const shifted = ast.binary(Add, ast.literal(BigNum(i)), y);
+        sum = ast.binary(Add, sum, ast.binary(Multiply, x, shifted));
+    }
+    auto const root = optimize(ast, sum);
+
+    auto const program = compile(ast, root);
+    EXPECT_LE(program.registers, 2);
+
+    auto const values = std::vector{BigNum(3), BigNum(5)};
+    Machine machine;
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(machine.run(program, values), BigNum(3 * (4950 + 500)));
+    }
+}
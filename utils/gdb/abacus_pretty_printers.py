@@ -1,10 +1,12 @@
 import gdb.printing
 
+DIGIT_BITS = 64
+
 def digits_to_num(digits):
     res = 0
     for d in reversed(digits):
-        res *= 10
-        res += d
+        res <<= DIGIT_BITS
+        res += int(d)
     return res
 
 class BigNumPrinter(object):
@@ -15,11 +17,10 @@ class BigNumPrinter(object):
 
     def to_string(self):
         digits = self.val['digits_']
-        begin, end = digits['_M_impl']['_M_start'], digits['_M_impl']['_M_finish']
+        begin, size = digits['data_'], int(digits['size_'])
         val = []
-        while begin != end:
-            val += [begin.dereference()]
-            begin += 1
+        for i in range(size):
+            val += [(begin + i).dereference()]
         val = digits_to_num(val)
         val *= self.val['sign_']
         return str(val)